@@ -0,0 +1,232 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <utility>
+
+using namespace std::chrono;
+
+// Allocation counting.
+// ----------------------------------------------------------------------------
+// Counted per thread so that allocations by zeromq background threads are not
+// attributed to the benchmarked operation.
+
+static thread_local uint64_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (const auto memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace libbitcoin {
+namespace client {
+namespace bench {
+
+typedef std::vector<std::pair<std::string, benchmark>> registry;
+
+static registry& benchmarks()
+{
+    static registry instance;
+    return instance;
+}
+
+uint64_t thread_allocations()
+{
+    return allocations;
+}
+
+registrar::registrar(const std::string& name, benchmark function)
+{
+    benchmarks().emplace_back(name, function);
+}
+
+// state
+// ----------------------------------------------------------------------------
+
+state::state(nanoseconds minimum_time)
+  : minimum_time_(minimum_time),
+    started_(false),
+    batch_(1),
+    remaining_(0),
+    iterations_(0),
+    allocations_(0),
+    paused_allocations_(0),
+    pause_allocations_(0),
+    bytes_(0),
+    paused_(0),
+    elapsed_(0)
+{
+}
+
+bool state::keep_running()
+{
+    if (remaining_ > 0)
+    {
+        --remaining_;
+        return true;
+    }
+
+    return next_batch();
+}
+
+// The clock is read once per batch, and the batch doubles until the minimum
+// time is reached, so clock overhead is amortized for very fast operations.
+bool state::next_batch()
+{
+    if (!started_)
+    {
+        started_ = true;
+        allocations_ = thread_allocations();
+        start_ = clock::now();
+        remaining_ = batch_ - 1;
+        return true;
+    }
+
+    iterations_ += batch_;
+    elapsed_ = duration_cast<nanoseconds>(clock::now() - start_) - paused_;
+
+    if (elapsed_ >= minimum_time_)
+    {
+        allocations_ = thread_allocations() - allocations_ -
+            paused_allocations_;
+        return false;
+    }
+
+    batch_ *= 2;
+    remaining_ = batch_ - 1;
+    return true;
+}
+
+void state::pause()
+{
+    pause_start_ = clock::now();
+    pause_allocations_ = thread_allocations();
+}
+
+void state::resume()
+{
+    paused_allocations_ += thread_allocations() - pause_allocations_;
+    paused_ += duration_cast<nanoseconds>(clock::now() - pause_start_);
+}
+
+void state::set_bytes(size_t bytes)
+{
+    bytes_ = bytes;
+}
+
+uint64_t state::iterations() const
+{
+    return iterations_;
+}
+
+size_t state::bytes() const
+{
+    return bytes_;
+}
+
+double state::nanoseconds_per_operation() const
+{
+    return iterations_ == 0 ? 0.0 :
+        static_cast<double>(elapsed_.count()) / iterations_;
+}
+
+double state::allocations_per_operation() const
+{
+    return iterations_ == 0 ? 0.0 :
+        static_cast<double>(allocations_) / iterations_;
+}
+
+// run
+// ----------------------------------------------------------------------------
+
+int run(const std::string& filter, nanoseconds minimum_time)
+{
+    std::cout
+        << std::left << std::setw(56) << "benchmark"
+        << std::right << std::setw(12) << "bytes"
+        << std::setw(12) << "iterations"
+        << std::setw(16) << "ns/op"
+        << std::setw(12) << "allocs/op"
+        << std::setw(12) << "MB/s" << std::endl;
+
+    for (const auto& benchmark: benchmarks())
+    {
+        if (!filter.empty() &&
+            benchmark.first.find(filter) == std::string::npos)
+            continue;
+
+        state result(minimum_time);
+        benchmark.second(result);
+
+        const auto nanoseconds = result.nanoseconds_per_operation();
+        const auto megabytes_per_second = nanoseconds == 0.0 ? 0.0 :
+            (result.bytes() * 1e3) / nanoseconds;
+
+        std::cout
+            << std::left << std::setw(56) << benchmark.first
+            << std::right << std::setw(12) << result.bytes()
+            << std::setw(12) << result.iterations()
+            << std::setw(16) << std::fixed << std::setprecision(1)
+            << nanoseconds
+            << std::setw(12) << std::setprecision(2)
+            << result.allocations_per_operation()
+            << std::setw(12) << std::setprecision(1)
+            << megabytes_per_second << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace bench
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_BENCH_BENCH_HPP
+#define LIBBITCOIN_CLIENT_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace libbitcoin {
+namespace client {
+namespace bench {
+
+/// Allocations made by the calling thread since process start.
+uint64_t thread_allocations();
+
+/// Timing state for one benchmark run, used as:
+///     while (state.keep_running()) { ...operation... }
+class state
+{
+public:
+    state(std::chrono::nanoseconds minimum_time);
+
+    /// True until the minimum time has elapsed, checked once per batch.
+    bool keep_running();
+
+    /// Exclude the time and allocations between pause and resume, such as
+    /// untimed setup within the loop. Each pair reads the clock twice, so
+    /// pause once per many operations rather than once per operation.
+    void pause();
+    void resume();
+
+    /// Bytes processed per operation, for throughput reporting.
+    void set_bytes(size_t bytes);
+
+    uint64_t iterations() const;
+    size_t bytes() const;
+    double nanoseconds_per_operation() const;
+    double allocations_per_operation() const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    bool next_batch();
+
+    const std::chrono::nanoseconds minimum_time_;
+    bool started_;
+    uint64_t batch_;
+    uint64_t remaining_;
+    uint64_t iterations_;
+    uint64_t allocations_;
+    uint64_t paused_allocations_;
+    uint64_t pause_allocations_;
+    size_t bytes_;
+    clock::time_point start_;
+    clock::time_point pause_start_;
+    std::chrono::nanoseconds paused_;
+    std::chrono::nanoseconds elapsed_;
+};
+
+typedef std::function<void(state&)> benchmark;
+
+/// Static registration of a named benchmark.
+struct registrar
+{
+    registrar(const std::string& name, benchmark function);
+};
+
+/// Run all registered benchmarks containing filter (all if empty).
+int run(const std::string& filter, std::chrono::nanoseconds minimum_time);
+
+} // namespace bench
+} // namespace client
+} // namespace libbitcoin
+
+#define BENCH_CASE(name) \
+    static void name(libbitcoin::client::bench::state& state); \
+    static const libbitcoin::client::bench::registrar \
+        name##_registrar(#name, &name); \
+    static void name(libbitcoin::client::bench::state& state)
+
+#endif
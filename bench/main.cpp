@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "bench.hpp"
+
+using namespace libbitcoin::client;
+
+/**
+ * Runs the registered benchmarks, reporting ns/op and allocations/op.
+ * usage: libbitcoin-client-bench [--min-time=<milliseconds>] [filter]
+ */
+int main(int argc, char* argv[])
+{
+    static const std::string min_time_option = "--min-time=";
+
+    std::string filter;
+    std::chrono::milliseconds minimum_time(250);
+
+    for (auto index = 1; index < argc; ++index)
+    {
+        const std::string argument(argv[index]);
+
+        if (argument.rfind(min_time_option, 0) == 0)
+        {
+            minimum_time = std::chrono::milliseconds(std::strtoul(
+                argument.substr(min_time_option.size()).c_str(), nullptr,
+                10));
+            continue;
+        }
+
+        if (!filter.empty())
+        {
+            std::cerr << "usage: " << argv[0]
+                << " [--min-time=<milliseconds>] [filter]" << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        filter = argument;
+    }
+
+    return bench::run(filter, minimum_time);
+}
@@ -0,0 +1,501 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <bitcoin/client.hpp>
+#include "bench.hpp"
+#include "../test/mock/obelisk_server.hpp"
+#include "../test/mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::system;
+
+// Benchmarks of the response decode paths registered by attach_handlers.
+// Handlers are registered through the public fetchers in untimed batches, and
+// each timed operation dispatches a prebuilt synthetic response payload to one
+// of them, as process_response does once the payload has been received.
+
+// Client that drops outgoing requests so responses can be injected directly.
+class bench_client
+  : public obelisk_client
+{
+public:
+    bench_client()
+      : obelisk_client(0)
+    {
+    }
+
+    // Ids of the requests sent since the last call.
+    std::vector<uint32_t> take_ids()
+    {
+        std::vector<uint32_t> ids;
+        ids.swap(ids_);
+        return ids;
+    }
+
+    using obelisk_client::handle_response;
+
+protected:
+    bool send_request(command, uint32_t id, const data_chunk&, bool,
+        size_t) override
+    {
+        ids_.push_back(id);
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> ids_;
+};
+
+// A benchmark of a payload that does not decode is meaningless.
+static void require_success(const code& ec, const std::string& name)
+{
+    if (!ec)
+        return;
+
+    std::cerr << name << " failed to decode: " << ec.message() << std::endl;
+    std::exit(EXIT_FAILURE);
+}
+
+// Handlers registered per untimed batch, amortizing the pause clock reads.
+static constexpr uint32_t handler_batch = 1024;
+
+// A transaction hash distinct for each index of a batch.
+static hash_digest index_hash(uint32_t index)
+{
+    auto hash = null_hash;
+    const auto bytes = to_little_endian(index);
+    std::copy(bytes.begin(), bytes.end(), hash.begin());
+    return hash;
+}
+
+// Registers handlers with fetch outside of the timed region, then dispatches
+// the payload to each of them in turn, timing only the response decode. The
+// fetch is given the index of the handler within its batch, which cacheable
+// fetches vary their request by, so that they are not coalesced.
+template <typename Fetch>
+static void dispatch(bench::state& state, command type,
+    const data_chunk& payload, Fetch fetch)
+{
+    bench_client client;
+    std::vector<uint32_t> ids;
+    size_t next = 0;
+    state.set_bytes(payload.size());
+
+    while (state.keep_running())
+    {
+        if (next == ids.size())
+        {
+            state.pause();
+            for (uint32_t index = 0; index < handler_batch; ++index)
+                fetch(client, index);
+
+            ids = client.take_ids();
+            next = 0;
+            state.resume();
+        }
+
+        client.handle_response(type, ids[next++], payload);
+    }
+}
+
+#define BENCH_SIZE(function, size) \
+    BENCH_CASE(function##__##size) \
+    { \
+        function(state, size); \
+    }
+
+// result_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(result_handler)
+{
+    const chain::transaction tx;
+    const auto handler = [](const code& ec)
+    {
+        require_success(ec, "result_handler");
+    };
+
+    dispatch(state, command::transaction_pool_broadcast, mock::code_payload(),
+        [&](bench_client& client, uint32_t)
+        {
+            client.transaction_pool_broadcast(handler, tx);
+        });
+}
+
+// version_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(version_handler)
+{
+    const auto handler = [](const code& ec, const std::string&)
+    {
+        require_success(ec, "version_handler");
+    };
+
+    dispatch(state, command::server_version, mock::version_payload(),
+        [&](bench_client& client, uint32_t)
+        {
+            client.server_version(handler);
+        });
+}
+
+// height_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(height_handler)
+{
+    const auto handler = [](const code& ec, size_t)
+    {
+        require_success(ec, "height_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_last_height, mock::height_payload(42),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_last_height(handler);
+        });
+}
+
+// transaction_index_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(transaction_index_handler)
+{
+    const auto handler = [](const code& ec, size_t, size_t)
+    {
+        require_success(ec, "transaction_index_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_transaction_index,
+        mock::transaction_index_payload(42, 1),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_transaction_index(handler, null_hash);
+        });
+}
+
+// block_header_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(block_header_handler)
+{
+    const auto handler = [](const code& ec, const chain::header&)
+    {
+        require_success(ec, "block_header_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_block_header, mock::header_payload(42),
+        [&](bench_client& client, uint32_t index)
+        {
+            client.blockchain_fetch_block_header(handler, index);
+        });
+}
+
+// transaction_handler (outputs per transaction)
+// ----------------------------------------------------------------------------
+
+static void transaction_handler(bench::state& state, size_t outputs)
+{
+    const auto handler = [](const code& ec, const chain::transaction&)
+    {
+        require_success(ec, "transaction_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_transaction,
+        mock::transaction_payload(outputs),
+        [&](bench_client& client, uint32_t index)
+        {
+            client.blockchain_fetch_transaction(handler, index_hash(index));
+        });
+}
+
+BENCH_SIZE(transaction_handler, 1)
+BENCH_SIZE(transaction_handler, 100)
+BENCH_SIZE(transaction_handler, 10000)
+
+// block_handler (transactions per block)
+// ----------------------------------------------------------------------------
+
+static void block_handler(bench::state& state, size_t transactions)
+{
+    const auto handler = [](const code& ec, const chain::block&)
+    {
+        require_success(ec, "block_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_block,
+        mock::block_payload(transactions),
+        [&](bench_client& client, uint32_t index)
+        {
+            client.blockchain_fetch_block(handler, index);
+        });
+}
+
+BENCH_SIZE(block_handler, 1)
+BENCH_SIZE(block_handler, 100)
+BENCH_SIZE(block_handler, 2000)
+BENCH_SIZE(block_handler, 10000)
+
+// block_view_handler (transactions per block)
+// ----------------------------------------------------------------------------
+
+static void block_view_handler(bench::state& state, size_t transactions)
+{
+    const auto handler = [](const code& ec, const block_view&)
+    {
+        require_success(ec, "block_view_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_block,
+        mock::block_payload(transactions),
+        [&](bench_client& client, uint32_t index)
+        {
+            client.blockchain_fetch_block_view(handler, index);
+        });
+}
+
+BENCH_SIZE(block_view_handler, 1)
+BENCH_SIZE(block_view_handler, 100)
+BENCH_SIZE(block_view_handler, 2000)
+BENCH_SIZE(block_view_handler, 10000)
+
+// hash_list_handler (hashes)
+// ----------------------------------------------------------------------------
+
+static void hash_list_handler(bench::state& state, size_t hashes)
+{
+    const auto handler = [](const code& ec, const hash_list&)
+    {
+        require_success(ec, "hash_list_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_block_transaction_hashes,
+        mock::hash_list_payload(hashes),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_block_transaction_hashes(handler, 42);
+        });
+}
+
+BENCH_SIZE(hash_list_handler, 10)
+BENCH_SIZE(hash_list_handler, 1000)
+BENCH_SIZE(hash_list_handler, 100000)
+
+// history_handler (payment rows)
+// ----------------------------------------------------------------------------
+
+static void history_handler(bench::state& state, size_t rows)
+{
+    const auto handler = [](const code& ec, const history::list&)
+    {
+        require_success(ec, "history_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_history4, mock::history_payload(rows),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_history4(handler, null_hash);
+        });
+}
+
+BENCH_SIZE(history_handler, 1000)
+BENCH_SIZE(history_handler, 100000)
+BENCH_SIZE(history_handler, 1000000)
+
+// history_chunks_handler (payment rows, delivered in chunks of 1000)
+// ----------------------------------------------------------------------------
+
+static void history_chunks_handler(bench::state& state, size_t rows)
+{
+    const auto handler = [](const code& ec, const history::list&, bool)
+    {
+        require_success(ec, "history_chunks_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_history4, mock::history_payload(rows),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_history4_chunks(handler, null_hash, 1000);
+        });
+}
+
+BENCH_SIZE(history_chunks_handler, 1000)
+BENCH_SIZE(history_chunks_handler, 100000)
+BENCH_SIZE(history_chunks_handler, 1000000)
+
+// history_columns_handler (payment rows, with a balance scan)
+// ----------------------------------------------------------------------------
+
+// Stored so that the balance scan is not optimized away.
+static volatile uint64_t balance_sink = 0;
+
+static void history_columns_handler(bench::state& state, size_t rows)
+{
+    const auto handler = [](const code& ec, const history_columns& columns)
+    {
+        require_success(ec, "history_columns_handler");
+        balance_sink = columns.balance();
+    };
+
+    dispatch(state, command::blockchain_fetch_history4, mock::history_payload(rows),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_history4_columns(handler, null_hash);
+        });
+}
+
+BENCH_SIZE(history_columns_handler, 1000)
+BENCH_SIZE(history_columns_handler, 100000)
+BENCH_SIZE(history_columns_handler, 1000000)
+
+// compact_filter_handler (filter bytes)
+// ----------------------------------------------------------------------------
+
+static void compact_filter_handler(bench::state& state, size_t bytes)
+{
+    const auto handler = [](const code& ec,
+        const message::compact_filter&)
+    {
+        require_success(ec, "compact_filter_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_compact_filter,
+        mock::compact_filter_payload(bytes),
+        [&](bench_client& client, uint32_t index)
+        {
+            client.blockchain_fetch_compact_filter(handler, 0, index);
+        });
+}
+
+BENCH_SIZE(compact_filter_handler, 100)
+BENCH_SIZE(compact_filter_handler, 10000)
+BENCH_SIZE(compact_filter_handler, 4000000)
+
+// compact_filter_checkpoint_handler (filter headers)
+// ----------------------------------------------------------------------------
+
+static void compact_filter_checkpoint_handler(bench::state& state,
+    size_t headers)
+{
+    const auto handler = [](const code& ec,
+        const message::compact_filter_checkpoint&)
+    {
+        require_success(ec, "compact_filter_checkpoint_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_compact_filter_checkpoint,
+        mock::compact_filter_checkpoint_payload(headers),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_compact_filter_checkpoint(handler, 0,
+                null_hash);
+        });
+}
+
+BENCH_SIZE(compact_filter_checkpoint_handler, 10)
+BENCH_SIZE(compact_filter_checkpoint_handler, 1000)
+BENCH_SIZE(compact_filter_checkpoint_handler, 100000)
+
+// compact_filter_headers_handler (filter hashes)
+// ----------------------------------------------------------------------------
+
+static void compact_filter_headers_handler(bench::state& state, size_t hashes)
+{
+    const auto handler = [](const code& ec,
+        const message::compact_filter_headers&)
+    {
+        require_success(ec, "compact_filter_headers_handler");
+    };
+
+    dispatch(state, command::blockchain_fetch_compact_filter_headers,
+        mock::compact_filter_headers_payload(hashes),
+        [&](bench_client& client, uint32_t)
+        {
+            client.blockchain_fetch_compact_filter_headers(handler, 0, 0,
+                null_hash);
+        });
+}
+
+BENCH_SIZE(compact_filter_headers_handler, 10)
+BENCH_SIZE(compact_filter_headers_handler, 2000)
+BENCH_SIZE(compact_filter_headers_handler, 100000)
+
+// notification_handler
+// ----------------------------------------------------------------------------
+
+BENCH_CASE(notification_handler)
+{
+    const auto payload = mock::notification_payload(1, 42, null_hash);
+    const auto handler = [](const code& ec, uint16_t, size_t,
+        const hash_digest&)
+    {
+        require_success(ec, "notification_handler");
+    };
+
+    // The subscription persists, so only the notification is repeated.
+    bench_client client;
+    const auto id = client.subscribe_key(handler, null_hash);
+    state.set_bytes(payload.size());
+
+    while (state.keep_running())
+        client.handle_response(command::notification_key, id, payload);
+}
+
+// round_trip (mock server, forwarded or direct send)
+// ----------------------------------------------------------------------------
+
+static void round_trip(bench::state& state, bool direct_send)
+{
+    mock::obelisk_server server;
+    obelisk_client client(0, direct_send);
+
+    if (!server.start() || !client.connect(server.endpoint()))
+    {
+        std::cerr << "round_trip failed to connect." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    const auto handler = [](const code& ec, size_t)
+    {
+        require_success(ec, "round_trip");
+    };
+
+    state.set_bytes(mock::height_payload(42).size());
+
+    while (state.keep_running())
+    {
+        client.blockchain_fetch_last_height(handler);
+        client.wait();
+    }
+}
+
+BENCH_CASE(round_trip__forwarded)
+{
+    round_trip(state, false);
+}
+
+BENCH_CASE(round_trip__direct_send)
+{
+    round_trip(state, true);
+}
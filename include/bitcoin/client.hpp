@@ -16,9 +16,27 @@
 
 #include <bitcoin/system.hpp>
 #include <bitcoin/protocol.hpp>
+#include <bitcoin/client/adaptive_limit.hpp>
+#include <bitcoin/client/block_decoder.hpp>
+#include <bitcoin/client/block_sequencer.hpp>
+#include <bitcoin/client/block_view.hpp>
+#include <bitcoin/client/command.hpp>
 #include <bitcoin/client/define.hpp>
+#include <bitcoin/client/filter_matcher.hpp>
+#include <bitcoin/client/filter_store.hpp>
+#include <bitcoin/client/filter_synchronizer.hpp>
+#include <bitcoin/client/header_store.hpp>
+#include <bitcoin/client/header_synchronizer.hpp>
 #include <bitcoin/client/history.hpp>
+#include <bitcoin/client/history_builder.hpp>
+#include <bitcoin/client/history_columns.hpp>
+#include <bitcoin/client/history_synchronizer.hpp>
+#include <bitcoin/client/mapped_file.hpp>
+#include <bitcoin/client/mpsc_queue.hpp>
 #include <bitcoin/client/obelisk_client.hpp>
+#include <bitcoin/client/request_table.hpp>
+#include <bitcoin/client/response_cache.hpp>
+#include <bitcoin/client/timer_wheel.hpp>
 #include <bitcoin/client/version.hpp>
 
 #endif
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_ADAPTIVE_LIMIT_HPP
+#define LIBBITCOIN_CLIENT_ADAPTIVE_LIMIT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Gradient limit of unanswered requests on one connection, tuned from the
+/// round trip times of its completed requests. The shortest recent round
+/// trip is taken as the unloaded latency of the server. While round trips
+/// stay near it the limit widens by about its square root per adjustment,
+/// and as queueing inflates them it shrinks in proportion, by at most half.
+/// A request that is not answered in time backs the limit off. Samples
+/// taken while the connection was well below its limit do not widen it.
+/// This is not thread safe.
+class BCC_API adaptive_limit
+{
+public:
+    typedef std::chrono::steady_clock::duration duration;
+
+    adaptive_limit(size_t initial=10, size_t minimum=1, size_t maximum=1000);
+
+    /// The number of unanswered requests to allow.
+    size_t limit() const;
+
+    /// Adjust to a request answered after round_trip, when in_flight
+    /// requests (including it) were unanswered on the connection.
+    void sample(const duration& round_trip, size_t in_flight);
+
+    /// Back off for a request that was not answered in time.
+    void drop();
+
+private:
+    void set(double limit);
+
+    const double minimum_;
+    const double maximum_;
+    double limit_;
+
+    // The unloaded latency estimate, refreshed from each window of samples
+    // so that it can rise with the server's load.
+    duration baseline_;
+    duration window_minimum_;
+    size_t window_samples_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_BLOCK_DECODER_HPP
+#define LIBBITCOIN_CLIENT_BLOCK_DECODER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Parses serialized blocks on a pool of worker threads, and delivers them
+/// in the order they were pushed. The notify handler is invoked on a worker
+/// thread after each block is parsed, so that the consumer may be woken to
+/// deliver. Push and deliver must be called on one (consumer) thread.
+class BCC_API block_decoder
+{
+public:
+    typedef std::function<void()> notify_handler;
+    typedef std::function<void(const system::chain::block&)> block_handler;
+
+    /// Start the number of worker threads, at least one.
+    block_decoder(size_t threads, notify_handler notify,
+        bool witness=true);
+
+    /// Stops the workers, discarding undelivered blocks.
+    ~block_decoder();
+
+    /// This class is not copyable.
+    block_decoder(const block_decoder&) = delete;
+    void operator=(const block_decoder&) = delete;
+
+    /// Queue a serialized block to be parsed.
+    void push(system::data_chunk&& data);
+
+    /// Invoke the handler with each parsed block, in push order, up to the
+    /// first that is not yet parsed. Returns the number delivered.
+    size_t deliver(const block_handler& handler);
+
+    /// The number of blocks pushed and not yet delivered.
+    size_t pending() const;
+
+private:
+    struct job
+    {
+        size_t ordinal;
+        system::data_chunk data;
+    };
+
+    struct result
+    {
+        bool parsed;
+        system::chain::block block;
+    };
+
+    void work();
+
+    const bool witness_;
+    const notify_handler notify_;
+    std::vector<std::thread> workers_;
+
+    // Pushed blocks are numbered, and results are kept in push order from
+    // the first that is undelivered, which is numbered delivered_.
+    size_t pushed_;
+    size_t delivered_;
+    std::deque<job> jobs_;
+    std::deque<result> results_;
+    bool stopping_;
+
+    // Protects jobs_, results_, delivered_ and stopping_.
+    mutable std::mutex mutex_;
+    std::condition_variable queued_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
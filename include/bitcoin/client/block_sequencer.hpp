@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_BLOCK_SEQUENCER_HPP
+#define LIBBITCOIN_CLIENT_BLOCK_SEQUENCER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+#include <utility>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Delivers serialized blocks of the block feed in height order, detecting
+/// heights that the feed skipped and fetching them. While heights are being
+/// fetched, blocks from the feed are held, and are delivered once the heights
+/// below them have been. A lower or equal height from the feed, as of a
+/// reorganization, is delivered as received. A fetch that fails (empty data)
+/// is retried by retry() after a delay that doubles with each failure, so
+/// that no height is skipped. A height that fails more than the retries is
+/// reported to the failure handler and fetched again on the next block from
+/// the feed. Heights are fetched only within a window above the last
+/// delivered, which bounds the blocks buffered for reordering. This is not
+/// thread safe.
+class BCC_API block_sequencer
+{
+public:
+    typedef std::function<void(size_t height)> fetch_handler;
+    typedef std::function<void(size_t height, system::data_chunk&& data)>
+        deliver_handler;
+    typedef std::function<void(size_t height)> failure_handler;
+    typedef std::chrono::steady_clock clock;
+
+    static constexpr size_t default_window = 8;
+    static constexpr size_t default_retries = 4;
+
+    /// The delay before the first retry of a height, doubled by each retry.
+    static constexpr std::chrono::milliseconds retry_delay{ 100 };
+
+    /// The handlers are invoked from within the calls of this class.
+    block_sequencer(fetch_handler fetch, deliver_handler deliver,
+        size_t window=default_window, failure_handler failed={},
+        size_t retries=default_retries);
+
+    /// Set the last height delivered, so that a later block from the feed
+    /// is preceded by those between. Without it the first block from the
+    /// feed sets the height.
+    void track(size_t last_height);
+
+    /// Fetch and deliver heights above the last, through the top height,
+    /// as when catching up on start. Requires a tracked height.
+    void backfill(size_t top_height);
+
+    /// A block received from the feed.
+    void live(size_t height, system::data_chunk&& data);
+
+    /// A block fetched by height, empty if the fetch failed, in which case
+    /// the height is fetched again by retry() or the next feed block.
+    void fetched(size_t height, system::data_chunk&& data);
+
+    /// Fetch failed heights whose retry delay has passed by now.
+    void retry(clock::time_point now=clock::now());
+
+    /// The time of the next retry, or max if none is due.
+    clock::time_point next_retry() const;
+
+    /// True if heights are being fetched.
+    bool backfilling() const;
+
+    /// True once a last height is set.
+    bool tracking() const;
+
+    /// The last height delivered.
+    size_t last_height() const;
+
+private:
+    void deliver(size_t height, system::data_chunk&& data);
+    void request();
+    void drain();
+
+    const fetch_handler fetch_;
+    const deliver_handler deliver_;
+    const failure_handler failed_;
+    const size_t window_;
+    const size_t retries_;
+
+    bool tracking_;
+    size_t last_;
+
+    // Heights from next_ through top_ remain to be fetched.
+    size_t next_;
+    size_t top_;
+    size_t in_flight_;
+
+    // Fetched blocks by height, and feed blocks held during backfill.
+    std::map<size_t, system::data_chunk> fetched_;
+    std::deque<std::pair<size_t, system::data_chunk>> held_;
+
+    // Failures by height, the retry time of each failed height, and heights
+    // that exceeded the retries, left for the next feed block.
+    std::map<size_t, size_t> failures_;
+    std::map<size_t, clock::time_point> retries_due_;
+    std::set<size_t> parked_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
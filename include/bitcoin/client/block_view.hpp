@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_BLOCK_VIEW_HPP
+#define LIBBITCOIN_CLIENT_BLOCK_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// A block over its serialized bytes, in a buffer that it shares, so that
+/// neither the block nor its transactions are copied. The header and the
+/// transaction count are parsed on construction, and a transaction is only
+/// parsed, from its bytes in the buffer, when requested. Transaction
+/// boundaries are found by skipping over the preceding transactions without
+/// allocation, and are retained, so ordered access visits each byte once.
+/// Copies share the buffer. This is not thread safe.
+class BCC_API block_view
+{
+public:
+    /// Iterates the transactions of the view, parsing each when dereferenced.
+    class BCC_API const_iterator
+    {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef system::chain::transaction value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef void pointer;
+        typedef system::chain::transaction reference;
+
+        const_iterator(const block_view& view, size_t index);
+
+        system::chain::transaction operator*() const;
+        const_iterator& operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator& other) const;
+        bool operator!=(const const_iterator& other) const;
+
+    private:
+        const block_view* view_;
+        size_t index_;
+    };
+
+    /// An invalid view.
+    block_view();
+
+    typedef std::shared_ptr<const system::data_chunk> buffer_ptr;
+
+    /// Parse the header and transaction count of the serialized block.
+    /// Set witness if the transactions may be in witness serialization.
+    block_view(system::data_chunk&& data, bool witness=false);
+
+    /// Parse the serialized block that follows the offset to the end of the
+    /// buffer, such as a response payload after its code.
+    block_view(buffer_ptr buffer, size_t offset, bool witness=false);
+
+    /// True if the header and transaction count were parsed.
+    bool is_valid() const;
+
+    /// The block header.
+    const system::chain::header& header() const;
+
+    /// The number of transactions claimed by the block.
+    size_t size() const;
+
+    /// Parse the transaction at the index, which is invalid if the index is
+    /// out of range or the transaction cannot be parsed.
+    system::chain::transaction transaction(size_t index) const;
+
+    /// A copy of the serialized transaction at the index, empty if it cannot
+    /// be found.
+    system::data_chunk transaction_data(size_t index) const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /// Parse the full block.
+    system::chain::block to_block() const;
+
+    /// The serialized block, valid while the view or a copy of it exists.
+    system::data_slice data() const;
+
+private:
+    bool locate(size_t index) const;
+
+    // Offsets are of the buffer, in which the block follows offset_.
+    buffer_ptr buffer_;
+    size_t offset_;
+    bool witness_;
+    bool valid_;
+    system::chain::header header_;
+    size_t count_;
+
+    // Offsets of the transactions located so far, and the end of the last.
+    mutable std::vector<size_t> offsets_;
+    mutable bool truncated_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,77 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_COMMAND_HPP
+#define LIBBITCOIN_CLIENT_COMMAND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Server commands, interned so that requests and responses are dispatched
+/// by index rather than by string.
+enum class command : uint8_t
+{
+    transaction_pool_broadcast,
+    transaction_pool_validate2,
+    transaction_pool_fetch_transaction,
+    transaction_pool_fetch_transaction2,
+    blockchain_broadcast,
+    blockchain_validate,
+    blockchain_fetch_transaction,
+    blockchain_fetch_transaction2,
+    blockchain_fetch_last_height,
+    blockchain_fetch_block,
+    blockchain_fetch_block_header,
+    blockchain_fetch_block_height,
+    blockchain_fetch_compact_filter,
+    blockchain_fetch_compact_filter_checkpoint,
+    blockchain_fetch_compact_filter_headers,
+    blockchain_fetch_transaction_index,
+    blockchain_fetch_history4,
+    blockchain_fetch_block_transaction_hashes,
+    subscribe_key,
+    notification_key,
+    unsubscribe_key,
+    server_version,
+
+    /// Not a command, the result of matching an unrecognized name.
+    unknown
+};
+
+/// The number of known commands.
+static constexpr size_t command_count = static_cast<size_t>(command::unknown);
+
+/// The wire name of the command, empty for unknown.
+BCC_API const std::string& command_name(command type);
+
+/// The command frame as sent to the server, built once per command.
+BCC_API const system::data_chunk& command_frame(command type);
+
+/// The command named by the frame, or unknown if not matched.
+BCC_API command to_command(const system::data_slice& frame);
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_FILTER_MATCHER_HPP
+#define LIBBITCOIN_CLIENT_FILTER_MATCHER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/filter_store.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Matches a set of items, such as the output scripts of a wallet, against
+/// BIP158 basic compact filters. For each block the items are hashed once
+/// under the block's key and radix sorted, and the Golomb-Rice coded set of
+/// the filter is decoded in order and merged with them, stopping at the
+/// first item in common. Filters of many blocks are matched in parallel on
+/// worker threads, each with its own scratch space. This is thread safe.
+class BCC_API filter_matcher
+{
+public:
+    /// The Golomb-Rice parameter of basic filters.
+    static constexpr uint8_t golomb_bits = 19;
+
+    /// The inverse false positive rate of basic filters.
+    static constexpr uint64_t golomb_rate = 784931;
+
+    /// The SipHash-2-4 of the item, keyed by the first 16 bytes of the block
+    /// hash, before it is mapped into the range of the filter.
+    static uint64_t siphash(const system::hash_digest& block_hash,
+        const system::data_chunk& item);
+
+    filter_matcher(const system::data_stack& items);
+
+    /// The number of items.
+    size_t size() const;
+
+    /// True if any item is in the filter of the block. A filter that is
+    /// not well formed matches nothing.
+    bool match(const system::hash_digest& block_hash,
+        const system::data_chunk& filter) const;
+
+    /// True if any item is in the filter of the block.
+    bool match(const system::hash_digest& block_hash, const uint8_t* filter,
+        size_t size) const;
+
+    /// The indexes of the filters with any item, in order, matched on up to
+    /// the number of threads (zero is one per core).
+    std::vector<size_t> match(
+        const std::vector<system::message::compact_filter>& filters,
+        size_t threads=0) const;
+
+    /// The heights from first through last of stored filters with any item,
+    /// in order, matched on up to the number of threads (zero is one per
+    /// core). The store must not change while matching.
+    std::vector<size_t> match(const filter_store& store, size_t first,
+        size_t last, size_t threads=0) const;
+
+private:
+    // Hashed items, and the buffer of their sort, reused across filters.
+    struct scratch
+    {
+        std::vector<uint64_t> hashes;
+        std::vector<uint64_t> buffer;
+    };
+
+    bool match(const system::hash_digest& block_hash, const uint8_t* filter,
+        size_t size, scratch& space) const;
+
+    template <typename Filter>
+    std::vector<size_t> match_all(size_t count, size_t threads,
+        const Filter& filter) const;
+
+    system::data_stack items_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_FILTER_STORE_HPP
+#define LIBBITCOIN_CLIENT_FILTER_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/mapped_file.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// The compact filters of a chain of blocks from genesis, of one filter
+/// type, indexed by height, in two memory mapped files of a directory. The
+/// index file begins with the number of filters and the length of the data
+/// committed by the last flush, followed by a fixed width record for each:
+/// its block hash, its filter header and the offset and size of the filter
+/// in the data file, to which filters are appended. The
+/// filter header of each is computed as it is appended (BIP157), so that
+/// the chain of filters can be checked against a server's filter headers.
+/// Block hashes are indexed as by header_store. Lookups may be concurrent
+/// with each other, but not with changes.
+class BCC_API filter_store
+{
+public:
+    /// A block hash, filter header, filter offset and filter size.
+    static constexpr size_t record_size = 2u * system::hash_size +
+        sizeof(uint64_t) + sizeof(uint32_t);
+
+    filter_store(const std::filesystem::path& directory, uint8_t filter_type);
+
+    /// This class is not copyable.
+    filter_store(const filter_store&) = delete;
+    void operator=(const filter_store&) = delete;
+
+    /// Open (or create) the files in the directory, which must exist, and
+    /// index the block hashes. Filters whose data was not committed by a
+    /// flush, and so may not have reached the disk before a crash, are
+    /// dropped.
+    bool open();
+
+    /// Flush, committing the filters, and close the files.
+    bool close();
+
+    /// The filter type of the store.
+    uint8_t filter_type() const;
+
+    /// The number of filters, one more than the top height.
+    size_t size() const;
+
+    /// True if there are no filters.
+    bool empty() const;
+
+    /// Append the filter of the block at the height of size().
+    bool push(const system::hash_digest& block_hash,
+        const system::data_chunk& filter);
+
+    /// Drop the filters at and above the height.
+    bool truncate(size_t height);
+
+    /// The filter at the height, false if above the top.
+    bool get(system::data_chunk& out, size_t height) const;
+
+    /// The filter at the height within the mapped file, without a copy,
+    /// null if above the top. It is valid until the store is changed.
+    const uint8_t* filter_data(size_t height, size_t& size) const;
+
+    /// The filter message at the height, false if above the top.
+    bool get(system::message::compact_filter& out, size_t height) const;
+
+    /// The height of the filter of the block, false if not stored.
+    bool get(size_t& out, const system::hash_digest& block_hash) const;
+
+    /// The block hash of the filter at the height, false if above the top.
+    bool block_hash(system::hash_digest& out, size_t height) const;
+
+    /// The filter header at the height, false if above the top.
+    bool filter_header(system::hash_digest& out, size_t height) const;
+
+    /// The filter header at the top, or the null hash if empty, to which the
+    /// next filter is chained.
+    system::hash_digest top_header() const;
+
+    /// Write stored filters to the files, then commit their data.
+    bool flush();
+
+private:
+    static constexpr size_t committed_offset = sizeof(uint64_t);
+    static constexpr size_t header_size = 2u * sizeof(uint64_t);
+    static constexpr uint32_t empty_slot = system::max_uint32;
+
+    const uint8_t* record(size_t height) const;
+    uint64_t offset(size_t height) const;
+    uint32_t filter_size(size_t height) const;
+    uint64_t data_end() const;
+    void set_size(size_t size);
+    uint64_t committed() const;
+    void set_committed(uint64_t size);
+    void index(size_t height);
+    void rebuild();
+
+    const uint8_t filter_type_;
+    mapped_file index_;
+    mapped_file data_;
+    size_t size_;
+
+    // Heights by block hash, with a power of two number of slots.
+    std::vector<uint32_t> slots_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_FILTER_SYNCHRONIZER_HPP
+#define LIBBITCOIN_CLIENT_FILTER_SYNCHRONIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/filter_store.hpp>
+#include <bitcoin/client/obelisk_client.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Downloads compact filters of the store's filter type into a filter
+/// store, in batches of heights. The filter hashes of a batch are fetched
+/// first, and then its filters by height with up to a window of requests
+/// unanswered, each checked against its hash and appended in height order.
+/// A batch whose previous filter header is not the top of the store is
+/// taken as a reorganization, so the top is dropped and the batch fetched
+/// again from below it. The store is flushed after each batch. Handlers are
+/// invoked on the thread that invokes the client's fetch handlers, so the
+/// download runs in the background of a started client. The synchronizer
+/// and store must outlive their requests. This is not thread safe.
+class BCC_API filter_synchronizer
+{
+public:
+    typedef obelisk_client::result_handler result_handler;
+
+    /// Heights whose filter hashes are fetched at once.
+    static constexpr size_t default_batch = 1000;
+
+    /// Requests for filters unanswered at once.
+    static constexpr size_t default_window = 64;
+
+    filter_synchronizer(obelisk_client& client, filter_store& store,
+        size_t batch=default_batch, size_t window=default_window);
+
+    /// Fetch the top height of the server, then filters above the top of
+    /// the store through it. A synchronization in progress is abandoned.
+    void synchronize(result_handler handler,
+        uint32_t timeout_milliseconds=0);
+
+    /// True while a synchronization is in progress.
+    bool synchronizing() const;
+
+private:
+    // A synchronization, shared by its requests, and abandoned by the next.
+    struct pass
+    {
+        result_handler handler;
+        size_t top;
+        size_t start;
+        size_t stop;
+        size_t next_request;
+        size_t in_flight;
+        uint32_t timeout_milliseconds;
+        system::hash_list filter_hashes;
+        std::map<size_t, system::message::compact_filter> buffer;
+        bool done;
+    };
+
+    typedef std::shared_ptr<pass> pass_ptr;
+
+    void request_batch(const pass_ptr& sync);
+    void handle_batch(const pass_ptr& sync, const system::code& ec,
+        const system::message::compact_filter_headers& headers);
+    void request(const pass_ptr& sync);
+    void handle(const pass_ptr& sync, size_t height, const system::code& ec,
+        const system::message::compact_filter& filter);
+    void complete(const pass_ptr& sync, const system::code& ec);
+
+    obelisk_client& client_;
+    filter_store& store_;
+    const size_t batch_;
+    const size_t window_;
+    pass_ptr current_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HEADER_STORE_HPP
+#define LIBBITCOIN_CLIENT_HEADER_STORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/mapped_file.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// A chain of block headers indexed by height, in a memory mapped file of
+/// fixed width records, each a serialized header and its hash. The file
+/// begins with the number of headers, and is grown ahead of the headers so
+/// that it is mapped again only occasionally. Hashes are indexed by an open
+/// addressing table of heights, built as the file is opened, so lookups in
+/// either direction read only memory. Lookups may be concurrent with each
+/// other, but not with changes.
+class BCC_API header_store
+{
+public:
+    /// A serialized header and its hash.
+    static constexpr size_t record_size = 80 + system::hash_size;
+
+    header_store(const std::filesystem::path& path);
+
+    /// This class is not copyable.
+    header_store(const header_store&) = delete;
+    void operator=(const header_store&) = delete;
+
+    /// Open (or create) the file and index its hashes.
+    bool open();
+
+    /// Flush and close the file.
+    bool close();
+
+    /// The number of headers, one more than the top height.
+    size_t size() const;
+
+    /// True if there are no headers.
+    bool empty() const;
+
+    /// Append the header at the height of size().
+    bool push(const system::chain::header& header);
+
+    /// Drop the headers at and above the height.
+    bool truncate(size_t height);
+
+    /// The header at the height, false if above the top.
+    bool get(system::chain::header& out, size_t height) const;
+
+    /// The hash of the header at the height, false if above the top.
+    bool get(system::hash_digest& out, size_t height) const;
+
+    /// The height of the header with the hash, false if not stored.
+    bool get(size_t& out, const system::hash_digest& hash) const;
+
+    /// Write stored headers to the file.
+    bool flush();
+
+private:
+    static constexpr size_t count_size = sizeof(uint64_t);
+    static constexpr uint32_t empty_slot = system::max_uint32;
+
+    const uint8_t* record(size_t height) const;
+    void set_size(size_t size);
+    void index(size_t height);
+    void rebuild();
+
+    mapped_file file_;
+    size_t size_;
+
+    // Heights by hash, with a power of two number of slots.
+    std::vector<uint32_t> slots_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HEADER_SYNCHRONIZER_HPP
+#define LIBBITCOIN_CLIENT_HEADER_SYNCHRONIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/header_store.hpp>
+#include <bitcoin/client/obelisk_client.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Downloads the header chain into a header store, fetching headers by
+/// height with up to a window of requests unanswered, and appending them in
+/// height order. A header that does not link to the top of the store is
+/// taken as a reorganization, so the top is dropped and headers are fetched
+/// again from below it. Handlers are invoked on the thread that invokes the
+/// client's fetch handlers, and the synchronizer and store must outlive
+/// their requests. This is not thread safe.
+class BCC_API header_synchronizer
+{
+public:
+    typedef obelisk_client::result_handler result_handler;
+
+    /// Requests for headers unanswered at once.
+    static constexpr size_t default_window = 64;
+
+    header_synchronizer(obelisk_client& client, header_store& store,
+        size_t window=default_window);
+
+    /// Fetch the top height of the server, then headers above the top of
+    /// the store through it. A synchronization in progress is abandoned.
+    void synchronize(result_handler handler,
+        uint32_t timeout_milliseconds=0);
+
+    /// Append a header of the block feed if it links to the top of the
+    /// store, otherwise synchronize. Returns true if appended.
+    bool update(const system::chain::header& header, result_handler handler,
+        uint32_t timeout_milliseconds=0);
+
+    /// True while a synchronization is in progress.
+    bool synchronizing() const;
+
+private:
+    // A synchronization, shared by its requests, and abandoned by the next.
+    struct pass
+    {
+        result_handler handler;
+        size_t top;
+        size_t next_request;
+        size_t in_flight;
+        uint32_t timeout_milliseconds;
+        std::map<size_t, system::chain::header> buffer;
+        bool done;
+    };
+
+    typedef std::shared_ptr<pass> pass_ptr;
+
+    void request(const pass_ptr& sync);
+    void handle(const pass_ptr& sync, size_t height, const system::code& ec,
+        const system::chain::header& header);
+    void complete(const pass_ptr& sync, const system::code& ec);
+    bool links(const system::chain::header& header) const;
+
+    obelisk_client& client_;
+    header_store& store_;
+    const size_t window_;
+    pass_ptr current_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
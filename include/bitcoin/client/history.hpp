@@ -65,6 +65,14 @@ struct BCC_API history
     };
 };
 
+/// Set the spend of a history row (see history_builder).
+inline void set_spend(history::list& rows, size_t row,
+    const system::chain::input_point& spend, uint64_t spend_height)
+{
+    rows[row].spend = spend;
+    rows[row].spend_height = spend_height;
+}
+
 } // namespace client
 } // namespace libbitcoin
 
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HISTORY_BUILDER_HPP
+#define LIBBITCOIN_CLIENT_HISTORY_BUILDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/history.hpp>
+#include <bitcoin/client/history_columns.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Expands payment rows into history rows in a single pass, correlating
+/// each spend with the output it spends. A spend row identifies its output
+/// only by the output's point checksum, so unspent outputs are indexed by
+/// checksum in an open addressing table sized for the expected rows. A
+/// spend that precedes its output (the server may write concurrently) is
+/// held in the table until the output arrives. Outputs with colliding
+/// checksums are spent in the order added. Spends never matched to an output
+/// are appended as spend-only rows by finish(). For streaming, all spends
+/// may be added first and each output then completed without being held,
+/// in which case the builder is constructed for spends only.
+/// Rows are appended to Rows by emplace_back, and a correlated spend is set
+/// on an appended row by set_spend (see history.hpp and history_columns.hpp).
+/// This is not thread safe.
+template <typename Rows>
+class basic_history_builder
+{
+public:
+    /// Selects the constructor for streaming, in which outputs are completed.
+    struct spends_only_t {};
+    static constexpr spends_only_t spends_only{};
+
+    /// Reserve for the expected number of payment rows (a hint only).
+    basic_history_builder(size_t rows);
+
+    /// Reserve for the expected number of spends (a hint only), reserving
+    /// no rows, as completed outputs are returned rather than appended.
+    basic_history_builder(size_t spends, spends_only_t);
+
+    /// Add an output row of the given value.
+    void add_output(const system::chain::output_point& output,
+        size_t height, uint64_t value);
+
+    /// Add a spend row of the output with the given point checksum.
+    void add_spend(const system::chain::input_point& spend, size_t height,
+        uint64_t checksum);
+
+    /// The row of an output, with its spend if already added. The row is
+    /// returned rather than held, so a later spend will not correlate to it.
+    history complete_output(const system::chain::output_point& output,
+        size_t height, uint64_t value);
+
+    /// Move out the history, outputs in the order added followed by any
+    /// uncorrelated spends in the order added. Call once.
+    Rows finish();
+
+private:
+    enum class state : uint8_t
+    {
+        empty,
+        output,
+        spend,
+        consumed
+    };
+
+    struct entry
+    {
+        uint64_t checksum;
+        uint32_t row;
+        state kind;
+    };
+
+    struct orphan
+    {
+        system::chain::input_point spend;
+        size_t height;
+        bool correlated;
+    };
+
+    entry* find(uint64_t checksum, state kind);
+    void insert(uint64_t checksum, uint32_t row, state kind);
+    void grow();
+    size_t slot(uint64_t checksum) const;
+
+    static size_t slot_bits(size_t rows);
+    static system::chain::input_point null_spend();
+
+    Rows rows_;
+    std::vector<orphan> orphans_;
+    std::vector<entry> table_;
+    size_t shift_;
+    size_t used_;
+};
+
+typedef basic_history_builder<history::list> history_builder;
+typedef basic_history_builder<history_columns> history_columns_builder;
+
+} // namespace client
+} // namespace libbitcoin
+
+#include <bitcoin/client/impl/history_builder.ipp>
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HISTORY_COLUMNS_HPP
+#define LIBBITCOIN_CLIENT_HISTORY_COLUMNS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/history.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// History in struct of arrays form, one element per row in each column.
+/// The columns carry the same values as the fields of history, with null
+/// points, and max heights and values, in the same places. Scans that touch
+/// only a few columns, such as of values and spend heights for a balance,
+/// read contiguous memory and may be vectorized by the compiler.
+struct BCC_API history_columns
+{
+    /// If there is no output the hash is null_hash and the index max.
+    std::vector<system::hash_digest> output_hashes;
+    std::vector<uint32_t> output_indexes;
+    std::vector<uint64_t> output_heights;
+
+    /// The satoshi value of the output, max if there is no output.
+    std::vector<uint64_t> values;
+
+    /// If there is no spend the hash is null_hash and the index max.
+    std::vector<system::hash_digest> spend_hashes;
+    std::vector<uint32_t> spend_indexes;
+
+    /// The height of the spend or max if no spend.
+    std::vector<uint64_t> spend_heights;
+
+    /// The number of rows.
+    size_t size() const;
+
+    /// True if there are no rows.
+    bool empty() const;
+
+    /// Reserve each column for the number of rows.
+    void reserve(size_t rows);
+
+    /// Append a row, as history is constructed.
+    void emplace_back(const system::chain::output_point& output,
+        uint64_t output_height, uint64_t value,
+        const system::chain::input_point& spend, uint64_t spend_height);
+
+    /// The row as history.
+    history row(size_t index) const;
+
+    /// The sum of the values of unspent outputs.
+    uint64_t balance() const;
+
+    /// The number of unspent outputs.
+    size_t unspent() const;
+};
+
+/// Set the spend of a history row (see history_builder).
+BCC_API void set_spend(history_columns& rows, size_t row,
+    const system::chain::input_point& spend, uint64_t spend_height);
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
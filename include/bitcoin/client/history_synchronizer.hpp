@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HISTORY_SYNCHRONIZER_HPP
+#define LIBBITCOIN_CLIENT_HISTORY_SYNCHRONIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+#include <bitcoin/client/history.hpp>
+#include <bitcoin/client/obelisk_client.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Keeps the history of each synchronized key, with the greatest height of
+/// its rows, and refreshes a key by fetching only rows from that height less
+/// an overlap. Cached rows at or above the fetch height are replaced by those
+/// fetched, and the height is that of the rows merged, so a reorganization
+/// no deeper than the overlap is corrected. Fetched spends of cached outputs
+/// are merged onto their output rows, and the merged history is delivered.
+/// Handlers are invoked on the thread that invokes the client's fetch
+/// handlers, and the synchronizer must outlive its requests. This is thread
+/// safe.
+class BCC_API history_synchronizer
+{
+public:
+    typedef obelisk_client::history_handler history_handler;
+
+    /// Blocks below the synchronized height that are fetched again.
+    static constexpr uint32_t default_overlap = 6;
+
+    history_synchronizer(obelisk_client& client,
+        uint32_t overlap=default_overlap);
+
+    /// Fetch the rows of the key from from_height(key), merge them into the
+    /// cached history and deliver it. On failure the cache is unchanged and
+    /// an empty history is delivered.
+    void synchronize(history_handler handler, const system::hash_digest& key,
+        uint32_t timeout_milliseconds=0);
+
+    /// The height from which the next synchronization of the key fetches.
+    uint32_t from_height(const system::hash_digest& key) const;
+
+    /// The cached history of the key, empty if not synchronized.
+    history::list cached(const system::hash_digest& key) const;
+
+    /// Drop the cached history of the key.
+    void forget(const system::hash_digest& key);
+
+    /// The number of keys cached.
+    size_t size() const;
+
+private:
+    struct entry
+    {
+        history::list rows;
+        uint32_t height;
+    };
+
+    typedef std::unordered_map<system::hash_digest, entry> cache;
+
+    // Replace cached rows at or above from with the payments, correlating
+    // fetched spends with cached outputs.
+    static void merge(entry& cached, uint32_t from,
+        const system::wallet::payment_record::list& payments);
+
+    obelisk_client& client_;
+    const uint32_t overlap_;
+    cache cache_;
+
+    // Protects cache_, which fetch handlers change on the client's thread.
+    mutable std::mutex mutex_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
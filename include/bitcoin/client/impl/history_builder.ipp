@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_HISTORY_BUILDER_IPP
+#define LIBBITCOIN_CLIENT_HISTORY_BUILDER_IPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+// The table is kept at most half full, so that probe runs stay short.
+template <typename Rows>
+size_t basic_history_builder<Rows>::slot_bits(size_t rows)
+{
+    static constexpr size_t minimum_bits = 4;
+
+    auto bits = minimum_bits;
+    while ((size_t{ 1 } << bits) < 2 * rows)
+        ++bits;
+
+    return bits;
+}
+
+template <typename Rows>
+system::chain::input_point basic_history_builder<Rows>::null_spend()
+{
+    return { system::null_hash, system::chain::point::null_index };
+}
+
+template <typename Rows>
+basic_history_builder<Rows>::basic_history_builder(size_t rows)
+  : table_(size_t{ 1 } << slot_bits(rows),
+        entry{ 0, 0, state::empty }),
+    shift_(64 - slot_bits(rows)),
+    used_(0)
+{
+    rows_.reserve(rows);
+}
+
+template <typename Rows>
+basic_history_builder<Rows>::basic_history_builder(size_t spends,
+    spends_only_t)
+  : table_(size_t{ 1 } << slot_bits(spends),
+        entry{ 0, 0, state::empty }),
+    shift_(64 - slot_bits(spends)),
+    used_(0)
+{
+    orphans_.reserve(spends);
+}
+
+template <typename Rows>
+size_t basic_history_builder<Rows>::slot(uint64_t checksum) const
+{
+    // Fibonacci hashing spreads checksums that share their high bits.
+    static constexpr uint64_t golden_ratio = 0x9e3779b97f4a7c15;
+    return static_cast<size_t>((checksum * golden_ratio) >> shift_);
+}
+
+template <typename Rows>
+typename basic_history_builder<Rows>::entry*
+basic_history_builder<Rows>::find(uint64_t checksum, state kind)
+{
+    const auto mask = table_.size() - 1;
+
+    // Consumed entries are left in place, so probing passes over them.
+    for (auto index = slot(checksum); table_[index].kind != state::empty;
+        index = (index + 1) & mask)
+    {
+        auto& candidate = table_[index];
+        if (candidate.kind == kind && candidate.checksum == checksum)
+            return &candidate;
+    }
+
+    return nullptr;
+}
+
+template <typename Rows>
+void basic_history_builder<Rows>::insert(uint64_t checksum, uint32_t row,
+    state kind)
+{
+    if (2 * (used_ + 1) > table_.size())
+        grow();
+
+    const auto mask = table_.size() - 1;
+    auto index = slot(checksum);
+    while (table_[index].kind != state::empty)
+        index = (index + 1) & mask;
+
+    table_[index] = { checksum, row, kind };
+    ++used_;
+}
+
+// Rehashing preserves the relative order of colliding entries, as each is
+// reinserted in table order from the start of its run.
+template <typename Rows>
+void basic_history_builder<Rows>::grow()
+{
+    std::vector<entry> previous(table_.size() * 2,
+        entry{ 0, 0, state::empty });
+    previous.swap(table_);
+    --shift_;
+    used_ = 0;
+
+    // Find the start of a run, so that wrapped runs are reinserted in order.
+    const auto size = previous.size();
+    size_t start = 0;
+    while (start < size && previous[start].kind != state::empty)
+        ++start;
+
+    for (size_t offset = 0; offset < size; ++offset)
+    {
+        const auto& old = previous[(start + offset) % size];
+        if (old.kind == state::output || old.kind == state::spend)
+            insert(old.checksum, old.row, old.kind);
+    }
+}
+
+template <typename Rows>
+void basic_history_builder<Rows>::add_output(
+    const system::chain::output_point& output, size_t height, uint64_t value)
+{
+    const auto checksum = output.checksum();
+    const auto row = static_cast<uint32_t>(rows_.size());
+
+    // The spend height is set on correlation, so no checksum is stored in it.
+    rows_.emplace_back(output, height, value, null_spend(), system::max_uint64);
+
+    const auto spend = find(checksum, state::spend);
+    if (spend == nullptr)
+    {
+        insert(checksum, row, state::output);
+        return;
+    }
+
+    auto& held = orphans_[spend->row];
+    set_spend(rows_, row, held.spend, held.height);
+    held.correlated = true;
+    spend->kind = state::consumed;
+}
+
+template <typename Rows>
+history basic_history_builder<Rows>::complete_output(
+    const system::chain::output_point& output, size_t height, uint64_t value)
+{
+    history row(output, height, value, null_spend(), system::max_uint64);
+
+    const auto spend = find(output.checksum(), state::spend);
+    if (spend != nullptr)
+    {
+        auto& held = orphans_[spend->row];
+        row.spend = held.spend;
+        row.spend_height = held.height;
+        held.correlated = true;
+        spend->kind = state::consumed;
+    }
+
+    return row;
+}
+
+template <typename Rows>
+void basic_history_builder<Rows>::add_spend(
+    const system::chain::input_point& spend, size_t height, uint64_t checksum)
+{
+    const auto output = find(checksum, state::output);
+    if (output == nullptr)
+    {
+        insert(checksum, static_cast<uint32_t>(orphans_.size()),
+            state::spend);
+        orphans_.push_back({ spend, height, false });
+        return;
+    }
+
+    set_spend(rows_, output->row, spend, height);
+    output->kind = state::consumed;
+}
+
+// This will only find spends if the history height cutoff comes between an
+// output and its spend. In this case we return just the spend.
+template <typename Rows>
+Rows basic_history_builder<Rows>::finish()
+{
+    for (const auto& held: orphans_)
+        if (!held.correlated)
+            rows_.emplace_back(system::chain::output_point{ null_spend() },
+                system::max_size_t, system::max_uint64, held.spend,
+                held.height);
+
+    return std::move(rows_);
+}
+
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
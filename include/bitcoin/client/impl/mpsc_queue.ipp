@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_MPSC_QUEUE_IPP
+#define LIBBITCOIN_CLIENT_MPSC_QUEUE_IPP
+
+#include <atomic>
+#include <utility>
+
+namespace libbitcoin {
+namespace client {
+
+template <typename Value>
+mpsc_queue<Value>::mpsc_queue()
+  : head_(new node{ { nullptr }, Value{} }), tail_(head_.load())
+{
+}
+
+template <typename Value>
+mpsc_queue<Value>::~mpsc_queue()
+{
+    Value value;
+    while (pop(value));
+
+    delete tail_;
+}
+
+template <typename Value>
+void mpsc_queue<Value>::push(Value&& value)
+{
+    const auto item = new node{ { nullptr }, std::move(value) };
+
+    // Linking the previous head completes the push for the consumer.
+    const auto previous = head_.exchange(item, std::memory_order_acq_rel);
+    previous->next.store(item, std::memory_order_release);
+}
+
+template <typename Value>
+bool mpsc_queue<Value>::pop(Value& out)
+{
+    const auto next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr)
+        return false;
+
+    // The popped node becomes the stub.
+    out = std::move(next->value);
+    delete tail_;
+    tail_ = next;
+    return true;
+}
+
+template <typename Value>
+bool mpsc_queue<Value>::empty() const
+{
+    return tail_->next.load(std::memory_order_acquire) == nullptr;
+}
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
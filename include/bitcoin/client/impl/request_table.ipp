@@ -0,0 +1,222 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_REQUEST_TABLE_IPP
+#define LIBBITCOIN_CLIENT_REQUEST_TABLE_IPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace libbitcoin {
+namespace client {
+
+template <typename Value>
+request_table<Value>::request_table(size_t capacity)
+  : slots_(), mask_(0), size_(0), minimum_(0), sparse_removals_(0),
+    shrunk_(false), regrown_(false)
+{
+    size_t size = 1;
+    while (size < std::min(std::max(capacity, size_t(1)), maximum_capacity))
+        size <<= 1;
+
+    slots_.resize(size);
+    mask_ = size - 1;
+    minimum_ = size;
+}
+
+template <typename Value>
+size_t request_table<Value>::index(uint32_t id) const
+{
+    return id & mask_;
+}
+
+template <typename Value>
+bool request_table<Value>::insert(uint32_t id, Value value)
+{
+    if (find(id) != nullptr)
+        return false;
+
+    while (slots_[index(id)].used)
+    {
+        if (slots_.size() < maximum_capacity)
+        {
+            grow();
+            continue;
+        }
+
+        // The ring is at its limit, so displace the older entry.
+        auto& displaced = slots_[index(id)];
+        overflow_.emplace(displaced.id, std::move(displaced.value));
+        displaced.used = false;
+        displaced.value = Value{};
+    }
+
+    auto& entry = slots_[index(id)];
+    entry.id = id;
+    entry.used = true;
+    entry.value = std::move(value);
+    ++size_;
+    return true;
+}
+
+template <typename Value>
+Value* request_table<Value>::find(uint32_t id)
+{
+    auto& entry = slots_[index(id)];
+    if (entry.used && entry.id == id)
+        return &entry.value;
+
+    if (overflow_.empty())
+        return nullptr;
+
+    const auto it = overflow_.find(id);
+    return it == overflow_.end() ? nullptr : &it->second;
+}
+
+template <typename Value>
+bool request_table<Value>::take(uint32_t id, Value& out)
+{
+    auto& entry = slots_[index(id)];
+    if (entry.used && entry.id == id)
+    {
+        out = std::move(entry.value);
+        entry.value = Value{};
+        entry.used = false;
+        --size_;
+        shrink();
+        return true;
+    }
+
+    if (overflow_.empty())
+        return false;
+
+    const auto it = overflow_.find(id);
+    if (it == overflow_.end())
+        return false;
+
+    out = std::move(it->second);
+    overflow_.erase(it);
+    --size_;
+    return true;
+}
+
+template <typename Value>
+bool request_table<Value>::erase(uint32_t id)
+{
+    Value value;
+    return take(id, value);
+}
+
+template <typename Value>
+template <typename Visitor>
+void request_table<Value>::drain(Visitor visitor)
+{
+    // Detach current entries so that visitor insertions are not visited.
+    slots detached(slots_.size());
+    overflow detached_overflow;
+    std::swap(detached, slots_);
+    std::swap(detached_overflow, overflow_);
+    size_ = 0;
+    sparse_removals_ = 0;
+    regrown_ = false;
+
+    for (auto& entry: detached)
+        if (entry.used)
+            visitor(entry.id, entry.value);
+
+    for (auto& entry: detached_overflow)
+        visitor(entry.first, entry.second);
+}
+
+template <typename Value>
+size_t request_table<Value>::size() const
+{
+    return size_;
+}
+
+template <typename Value>
+bool request_table<Value>::empty() const
+{
+    return size_ == 0;
+}
+
+template <typename Value>
+size_t request_table<Value>::capacity() const
+{
+    return slots_.size();
+}
+
+// Existing entries cannot collide after doubling, as each new index is
+// congruent to its old index modulo the old capacity. Doubling a ring that
+// was halved means a surviving id collides at the smaller size, so halving
+// is then suspended until the table empties.
+template <typename Value>
+void request_table<Value>::grow()
+{
+    regrown_ = regrown_ || shrunk_;
+    shrunk_ = false;
+    slots grown(slots_.size() * 2);
+    mask_ = grown.size() - 1;
+
+    for (auto& entry: slots_)
+        if (entry.used)
+            grown[index(entry.id)] = std::move(entry);
+
+    slots_ = std::move(grown);
+}
+
+// The check and the move each visit every slot, so the ring is visited at
+// most once for each of as many removals as it has slots. An entry collides
+// after halving only with the entry in the other half at the same offset.
+template <typename Value>
+void request_table<Value>::shrink()
+{
+    if (size_ == 0)
+        regrown_ = false;
+
+    if (regrown_ || slots_.size() <= minimum_ ||
+        size_ * 4u >= slots_.size())
+    {
+        sparse_removals_ = 0;
+        return;
+    }
+
+    if (++sparse_removals_ < slots_.size())
+        return;
+
+    sparse_removals_ = 0;
+    const auto half = slots_.size() / 2u;
+    for (size_t offset = 0; offset < half; ++offset)
+        if (slots_[offset].used && slots_[offset + half].used)
+            return;
+
+    for (size_t offset = 0; offset < half; ++offset)
+        if (slots_[offset + half].used)
+            slots_[offset] = std::move(slots_[offset + half]);
+
+    slots_.resize(half);
+    mask_ = half - 1;
+    shrunk_ = true;
+}
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
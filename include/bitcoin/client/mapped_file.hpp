@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_MAPPED_FILE_HPP
+#define LIBBITCOIN_CLIENT_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// A file mapped into memory for reading and writing, which is created if it
+/// does not exist. The mapping covers the whole file, and is replaced when
+/// the file is resized, which invalidates pointers into it. Writes through
+/// the mapping reach the file when flushed or closed. This is not thread
+/// safe.
+class BCC_API mapped_file
+{
+public:
+    mapped_file(const std::filesystem::path& path);
+
+    /// Unmaps and closes the file.
+    ~mapped_file();
+
+    /// This class is not copyable.
+    mapped_file(const mapped_file&) = delete;
+    void operator=(const mapped_file&) = delete;
+
+    /// Open (or create) and map the file.
+    bool open();
+
+    /// Flush, unmap and close the file.
+    bool close();
+
+    /// True if the file is open.
+    bool is_open() const;
+
+    /// The size of the file and its mapping in bytes.
+    size_t size() const;
+
+    /// The mapped file, null if empty or closed.
+    uint8_t* data();
+    const uint8_t* data() const;
+
+    /// Set the size of the file and map it again. Added bytes are zero.
+    bool resize(size_t size);
+
+    /// Grow the file to at least the size, by at least half its size, so
+    /// that a file grown by small increments is mapped only a few times.
+    bool reserve(size_t size);
+
+    /// Write the mapped bytes to the file.
+    bool flush();
+
+private:
+    bool map();
+    bool unmap();
+
+    const std::filesystem::path path_;
+    size_t size_;
+    uint8_t* data_;
+
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int file_;
+#endif
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
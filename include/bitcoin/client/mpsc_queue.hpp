@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_MPSC_QUEUE_HPP
+#define LIBBITCOIN_CLIENT_MPSC_QUEUE_HPP
+
+#include <atomic>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Unbounded lock-free queue of many producers and a single consumer.
+/// A push is one atomic exchange and one store, and never blocks. A pop may
+/// report empty while a concurrent push is between its exchange and store,
+/// in which case the value is visible once that push returns.
+template <typename Value>
+class mpsc_queue
+{
+public:
+    mpsc_queue();
+    ~mpsc_queue();
+
+    /// This class is not copyable.
+    mpsc_queue(const mpsc_queue&) = delete;
+    void operator=(const mpsc_queue&) = delete;
+
+    /// Add a value, safe to call from any thread.
+    void push(Value&& value);
+
+    /// Remove the oldest value, false if empty (consumer thread only).
+    bool pop(Value& out);
+
+    /// True if no value is available (consumer thread only).
+    bool empty() const;
+
+private:
+    struct node
+    {
+        std::atomic<node*> next;
+        Value value;
+    };
+
+    // Producers append at the head, the consumer removes after the tail.
+    // The tail is a stub node whose value has already been consumed.
+    std::atomic<node*> head_;
+    node* tail_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#include <bitcoin/client/impl/mpsc_queue.ipp>
+
+#endif
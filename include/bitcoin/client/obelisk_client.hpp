@@ -19,9 +19,29 @@
 #ifndef LIBBITCOIN_CLIENT_OBELISK_CLIENT_HPP
 #define LIBBITCOIN_CLIENT_OBELISK_CLIENT_HPP
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+#include <vector>
 #include <bitcoin/system.hpp>
+#include <bitcoin/client/adaptive_limit.hpp>
+#include <bitcoin/client/block_decoder.hpp>
+#include <bitcoin/client/block_sequencer.hpp>
+#include <bitcoin/client/block_view.hpp>
+#include <bitcoin/client/command.hpp>
 #include <bitcoin/client/define.hpp>
 #include <bitcoin/client/history.hpp>
+#include <bitcoin/client/history_columns.hpp>
+#include <bitcoin/client/mpsc_queue.hpp>
+#include <bitcoin/client/request_table.hpp>
+#include <bitcoin/client/response_cache.hpp>
+#include <bitcoin/client/timer_wheel.hpp>
 #include <bitcoin/protocol.hpp>
 
 namespace libbitcoin {
@@ -37,6 +57,18 @@ struct BCC_API connection_settings
     system::config::authority socks;
     protocol::zmq::sodium server_public_key;
     protocol::zmq::sodium client_private_key;
+
+    /// Send requests directly on the server socket (see obelisk_client).
+    bool direct_send = false;
+
+    /// Additional request connections, each to be balanced with server.
+    std::vector<system::config::endpoint> pool;
+
+    /// Limit of unanswered requests across connections (zero is unlimited).
+    size_t window = 0;
+
+    /// Limit unanswered requests on each connection adaptively.
+    bool adaptive = false;
 };
 
 /// Client implements a router-dealer interface to communicate with
@@ -46,9 +78,13 @@ class BCC_API obelisk_client
 public:
     static const auto null_subscription = bc::max_uint32;
 
-    typedef std::function<void(const std::string&, uint32_t,
+    typedef std::function<void(command, uint32_t,
         const system::data_chunk&)> command_handler;
-    typedef std::unordered_map<std::string, command_handler> command_map;
+    typedef std::array<command_handler, command_count> command_map;
+
+    /// Invoked with true when the request window fills and requests begin to
+    /// be held, and with false once all held requests have been sent.
+    typedef std::function<void(bool)> backpressure_handler;
 
     // Subscription/notification handler types.
     //-------------------------------------------------------------------------
@@ -57,9 +93,14 @@ public:
         const system::hash_digest&)> update_handler;
     typedef std::function<void(const system::chain::block&)>
         block_update_handler;
+    typedef std::function<void(const client::block_view&)>
+        block_view_update_handler;
     typedef std::function<void(const system::chain::transaction&)>
         transaction_update_handler;
 
+    /// Invoked with the number of messages missed by a feed.
+    typedef std::function<void(size_t)> feed_gap_handler;
+
     // Fetch handler types.
     //-------------------------------------------------------------------------
 
@@ -67,6 +108,8 @@ public:
     typedef std::function<void(const system::code&, size_t)> height_handler;
     typedef std::function<void(const system::code&, size_t, size_t)> transaction_index_handler;
     typedef std::function<void(const system::code&, const system::chain::block&)> block_handler;
+    typedef std::function<void(const system::code&, const client::block_view&)> block_view_handler;
+    typedef std::function<void(const system::code&, size_t, const system::chain::block&)> block_range_handler;
     typedef std::function<void(const system::code&, const system::chain::header&)> block_header_handler;
     typedef std::function<void(const system::code&, const system::message::compact_filter&)> compact_filter_handler;
     typedef std::function<void(const system::code&, const system::message::compact_filter_checkpoint&)> compact_filter_checkpoint_handler;
@@ -74,33 +117,54 @@ public:
     typedef std::function<void(const system::code&, const system::chain::transaction&)> transaction_handler;
     typedef std::function<void(const system::code&, const system::chain::points_value&)> points_value_handler;
     typedef std::function<void(const system::code&, const client::history::list&)> history_handler;
+    typedef std::function<void(const system::code&, const client::history::list&, bool)> history_chunk_handler;
+    typedef std::function<void(const system::code&, const client::history_columns&)> history_columns_handler;
+    typedef std::function<void(const system::code&, const system::wallet::payment_record::list&)> payment_handler;
     typedef std::function<void(const system::code&, const system::hash_list&)> hash_list_handler;
     typedef std::function<void(const system::code&, const std::string&)> version_handler;
 
-    // Used for mapping specific requests to specific handlers
-    // (allowing support for different handlers for different client
-    // API calls on a per-client instance basis).
-    typedef std::unordered_map<uint32_t, result_handler> result_handler_map;
-    typedef std::unordered_map<uint32_t, height_handler> height_handler_map;
-    typedef std::unordered_map<uint32_t, transaction_index_handler> transaction_index_handler_map;
-    typedef std::unordered_map<uint32_t, block_handler> block_handler_map;
-    typedef std::unordered_map<uint32_t, block_header_handler> block_header_handler_map;
-    typedef std::unordered_map<uint32_t, compact_filter_handler> compact_filter_handler_map;
-    typedef std::unordered_map<uint32_t, compact_filter_checkpoint_handler> compact_filter_checkpoint_handler_map;
-    typedef std::unordered_map<uint32_t, compact_filter_headers_handler> compact_filter_headers_handler_map;
-    typedef std::unordered_map<uint32_t, transaction_handler> transaction_handler_map;
-    typedef std::unordered_map<uint32_t, history_handler> history_handler_map;
+    // A chunked history handler and the number of rows in each chunk.
+    struct history_chunks
+    {
+        history_chunk_handler handler;
+        size_t rows;
+    };
+
+    // Pending request handlers, one per request id, share a single table.
+    typedef std::variant<
+        result_handler,
+        height_handler,
+        transaction_index_handler,
+        block_handler,
+        block_view_handler,
+        block_header_handler,
+        compact_filter_handler,
+        compact_filter_checkpoint_handler,
+        compact_filter_headers_handler,
+        transaction_handler,
+        history_handler,
+        history_chunks,
+        history_columns_handler,
+        payment_handler,
+        hash_list_handler,
+        version_handler> request_handler;
+
+    // Subscription handlers persist beyond the response, so are kept apart.
     typedef std::unordered_map<uint32_t, std::pair<update_handler,
         system::data_chunk>> subscription_handler_map;
     typedef std::unordered_map<uint32_t, std::pair<result_handler,
         uint32_t>> unsubscription_handler_map;
-    typedef std::unordered_map<uint32_t, hash_list_handler> hash_list_handler_map;
-    typedef std::unordered_map<uint32_t, version_handler> version_handler_map;
 
     /// Construct an instance of the client.
-    obelisk_client(int32_t retries=5);
+    /// If direct_send is set requests are sent on the server socket when
+    /// submitted, rather than forwarded by wait() through an inproc router.
+    /// In this mode fetchers must be called on the thread that calls wait().
+    obelisk_client(int32_t retries=5, bool direct_send=false);
 
-    ~obelisk_client();
+    /// The default depth below which responses by height are cached.
+    static constexpr size_t default_cache_depth = 6;
+
+    virtual ~obelisk_client();
 
     /// Connect to the specified endpoint using the provided keys.
     bool connect(const system::config::endpoint& address,
@@ -114,94 +178,240 @@ public:
     /// Connect using the provided settings.
     bool connect(const connection_settings& settings);
 
+    /// Connect to the first endpoint, with a further request connection to
+    /// each endpoint (an endpoint may be repeated for more connections).
+    /// Each request is sent on the connection with the fewest unanswered
+    /// requests. Subscriptions use the first endpoint only.
+    bool connect(const std::vector<system::config::endpoint>& addresses);
+
+    /// The number of request connections.
+    size_t connections() const;
+
+    /// The number of unanswered requests sent on the connection.
+    size_t outstanding(size_t connection) const;
+
+    /// Limit the number of unanswered requests across connections to window
+    /// (zero is unlimited). Requests beyond the window are held in order and
+    /// sent as earlier requests complete, and their timeouts run while held.
+    /// The handler is invoked on the thread that sends requests. Must not be
+    /// called while running.
+    void set_window(size_t window, backpressure_handler handler={});
+
+    /// True while requests are held by a full window.
+    bool backlogged() const;
+
+    /// Also limit unanswered requests on each connection, to a limit tuned
+    /// from the round trip times of its answered requests (see
+    /// adaptive_limit). Requests that no connection admits are held as by
+    /// the window. Must not be called while running.
+    void set_adaptive(bool adaptive);
+
+    /// The adaptive limit of unanswered requests on the connection, which
+    /// is tuned whether or not it is enforced.
+    size_t limit(size_t connection) const;
+
+    /// Parse blocks of the block feed on the number of worker threads, so
+    /// that monitor() is not stalled by large blocks. Blocks are delivered
+    /// by monitor() in the order received, and a block parsed after
+    /// monitor() returns is delivered by the next call. Zero (the default)
+    /// parses on the thread that calls monitor(), and a change discards
+    /// undelivered blocks. Must not be called while monitoring.
+    bool set_block_decoders(size_t threads);
+
+    /// Deliver blocks of the block feed in height order from the last height
+    /// delivered. Heights the feed skips are fetched, and feed blocks are
+    /// held until those below them are delivered (see block_sequencer).
+    /// Heights above the last through the top height are fetched now, to
+    /// catch up on start. The fetches are answered by wait() or the reactor
+    /// as are other requests, and the blocks delivered by monitor(). A failed
+    /// fetch is retried by monitor() after a growing delay, and a height that
+    /// still fails is passed to on_gap and fetched again on the next feed
+    /// block. Must not be called while monitoring.
+    bool track_blocks(size_t last_height, size_t top_height=0,
+        feed_gap_handler on_gap={});
+
+    /// The height of the last block delivered, once tracked.
+    size_t block_height() const;
+
+    /// Cache successful responses of fetchers whose responses do not change,
+    /// within the budget of bytes (zero, the default, disables the cache).
+    /// These are blocks, block views, headers and compact filters, and
+    /// transactions by hash. Those fetched by height are cached only once
+    /// buried by depth blocks, below the highest height seen in a height
+    /// response or on the block feed. A cached request is answered by wait()
+    /// or the reactor, as are other requests, but is not sent. Must not be
+    /// called while running.
+    void set_cache(size_t budget_bytes, size_t depth=default_cache_depth);
+
+    /// The response cache, or null if not set, for its counters.
+    response_cache* cache() const;
+
     /// Wait for server to respond to queries, until timeout.
     void wait(uint32_t timeout_milliseconds=30000);
 
     /// Monitor for subscription notifications, until timeout.
     void monitor(uint32_t timeout_milliseconds=30000);
 
+    /// Run the request poll loop on an owned thread, after connect.
+    /// While running, fetchers may be called concurrently from any thread,
+    /// requests progress without wait(), and fetch handlers are invoked on
+    /// the reactor thread. Do not call wait() while running. Subscriptions
+    /// are not affected and still require monitor().
+    bool start();
+
+    /// Stop and join the reactor thread, failing any unanswered requests
+    /// with service_stopped. Must not be called concurrently with fetchers.
+    void stop();
+
     // Fetchers.
     //-------------------------------------------------------------------------
+    // A nonzero timeout_milliseconds fails the request with channel_timeout
+    // if not answered in time, otherwise it is bounded only by wait().
+    // A fetch of a block, block view, header, compact filter or transaction
+    // (by hash) that is identical to one in flight with the same handler type
+    // joins that request, and completes with it or by its own timeout. One
+    // that would outlive the deadline of the request in flight is sent.
 
-    void server_version(version_handler handler);
+    void server_version(version_handler handler,
+        uint32_t timeout_milliseconds=0);
 
     void transaction_pool_broadcast(result_handler handler,
-        const system::chain::transaction& tx);
+        const system::chain::transaction& tx,
+        uint32_t timeout_milliseconds=0);
 
     void transaction_pool_validate2(result_handler handler,
-        const system::chain::transaction& tx);
+        const system::chain::transaction& tx,
+        uint32_t timeout_milliseconds=0);
 
     void transaction_pool_fetch_transaction(transaction_handler handler,
-        const system::hash_digest& tx_hash);
+        const system::hash_digest& tx_hash,
+        uint32_t timeout_milliseconds=0);
 
     void transaction_pool_fetch_transaction2(transaction_handler handler,
-        const system::hash_digest& tx_hash);
+        const system::hash_digest& tx_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_broadcast(result_handler handler,
-        const system::chain::block& block);
+        const system::chain::block& block,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_validate(result_handler handler,
-        const system::chain::block& block);
+        const system::chain::block& block,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_transaction(transaction_handler handler,
-        const system::hash_digest& tx_hash);
+        const system::hash_digest& tx_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_transaction2(transaction_handler handler,
-        const system::hash_digest& tx_hash);
+        const system::hash_digest& tx_hash,
+        uint32_t timeout_milliseconds=0);
 
-    void blockchain_fetch_last_height(height_handler handler);
+    void blockchain_fetch_last_height(height_handler handler,
+        uint32_t timeout_milliseconds=0);
 
-    void blockchain_fetch_block(block_handler handler, uint32_t height);
+    void blockchain_fetch_block(block_handler handler, uint32_t height,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block(block_handler handler,
-        const system::hash_digest& block_hash);
+        const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
+
+    /// Fetch a block, parsing only its header until transactions are read.
+    void blockchain_fetch_block_view(block_view_handler handler,
+        uint32_t height, uint32_t timeout_milliseconds=0);
+
+    void blockchain_fetch_block_view(block_view_handler handler,
+        const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
+
+    /// Fetch the blocks from the first through the last height, with up to
+    /// window requests unanswered. Blocks are delivered in height order with
+    /// their heights, so that no more than window blocks are buffered. The
+    /// first failure is delivered with its height and ends the range.
+    void blockchain_fetch_blocks(block_range_handler handler,
+        uint32_t first_height, uint32_t last_height, size_t window=8,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block_header(block_header_handler handler,
-        uint32_t height);
+        uint32_t height,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block_header(block_header_handler handler,
-        const system::hash_digest& block_hash);
+        const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_transaction_index(transaction_index_handler handler,
-        const system::hash_digest& tx_hash);
+        const system::hash_digest& tx_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block_height(height_handler handler,
-        const system::hash_digest& block_hash);
+        const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block_transaction_hashes(
-        hash_list_handler handler, uint32_t height);
+        hash_list_handler handler, uint32_t height,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_block_transaction_hashes(
-        hash_list_handler handler, const system::hash_digest& block_hash);
+        hash_list_handler handler, const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_compact_filter(compact_filter_handler handler,
-        uint8_t filter_type, uint32_t height);
+        uint8_t filter_type, uint32_t height,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_compact_filter(compact_filter_handler handler,
-        uint8_t filter_type, const system::hash_digest& block_hash);
+        uint8_t filter_type, const system::hash_digest& block_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_compact_filter_headers(
         compact_filter_headers_handler handler, uint8_t filter_type,
-        uint32_t start_height, const system::hash_digest& stop_hash);
+        uint32_t start_height, const system::hash_digest& stop_hash,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_compact_filter_headers(
         compact_filter_headers_handler handler, uint8_t filter_type,
-        uint32_t start_height, uint32_t stop_height);
+        uint32_t start_height, uint32_t stop_height,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_compact_filter_checkpoint(
         compact_filter_checkpoint_handler handler, uint8_t filter_type,
-        const system::hash_digest& stop_hash);
+        const system::hash_digest& stop_hash,
+        uint32_t timeout_milliseconds=0);
 
 //    void blockchain_fetch_compact_filter_checkpoint(
 //        compact_filter_checkpoint_handler handler, uint8_t filter_type,
 //        uint32_t stop_height);
 
     void blockchain_fetch_history4(history_handler handler,
-        const system::hash_digest& key, uint32_t from_height=0);
+        const system::hash_digest& key, uint32_t from_height=0,
+        uint32_t timeout_milliseconds=0);
+
+    /// Deliver the history in chunks of up to chunk_rows rows, the last of
+    /// which (possibly empty) is flagged complete. Spends are indexed before
+    /// delivery and each output row is released once delivered, so that the
+    /// history is never held in full. A failure is a single empty chunk.
+    void blockchain_fetch_history4_chunks(history_chunk_handler handler,
+        const system::hash_digest& key, size_t chunk_rows,
+        uint32_t from_height=0, uint32_t timeout_milliseconds=0);
+
+    /// Deliver the history in columns (see history_columns), which are
+    /// filled directly as the payload is decoded.
+    void blockchain_fetch_history4_columns(history_columns_handler handler,
+        const system::hash_digest& key, uint32_t from_height=0,
+        uint32_t timeout_milliseconds=0);
+
+    /// Deliver the history as received, one payment record per output or
+    /// spend, with each spend identified by the checksum of its output.
+    void blockchain_fetch_history4_payments(payment_handler handler,
+        const system::hash_digest& key, uint32_t from_height=0,
+        uint32_t timeout_milliseconds=0);
 
     void blockchain_fetch_unspent_outputs(points_value_handler handler,
         const system::hash_digest& key, uint64_t satoshi,
-        system::chain::points_value::selection algorithm);
+        system::chain::points_value::selection algorithm,
+        uint32_t timeout_milliseconds=0);
 
     // Subscribers.
     //-------------------------------------------------------------------------
@@ -213,22 +423,201 @@ public:
     bool subscribe_block(const system::config::endpoint& address,
         block_update_handler on_update);
 
+    /// Subscribe to blocks, parsing only the header of each until its
+    /// transactions are read. This replaces a block_update_handler.
+    bool subscribe_block_view(const system::config::endpoint& address,
+        block_view_update_handler on_update);
+
+    /// The gap handler is invoked by monitor() with the number of
+    /// transactions missed, as detected from the feed sequence.
     bool subscribe_transaction(const system::config::endpoint& address,
-        transaction_update_handler on_update);
+        transaction_update_handler on_update, feed_gap_handler on_gap={});
 
     // Unsubscribers.
     //-------------------------------------------------------------------------
 
     bool unsubscribe_key(result_handler handler, uint32_t subscription);
 
+protected:
+    // Sends an outgoing request via the internal router, or directly to the
+    // server if direct_send is set (virtual for test).
+    virtual bool send_request(command type, uint32_t id,
+        const system::data_chunk& payload, bool subscription=false,
+        size_t connection=0);
+
+    // Dispatch a server response to the handler registered for the command.
+    void handle_response(command type, uint32_t id,
+        const system::data_chunk& payload);
+
+    // Dispatch a shared server response, which a block view shares.
+    void handle_response(command type, uint32_t id,
+        const response_cache::value& payload);
+
 private:
     // Attach handlers for all supported client-server operations.
     void attach_handlers();
 
     // Used to handle a request immediately, on early detection of error.
-    void handle_immediate(const std::string& command, uint32_t id,
+    void handle_immediate(command type, uint32_t id,
         const system::code& ec);
 
+    // Removes the handler pending for the request id, if of Handler type,
+    // joined with the handlers of requests coalesced into it and pending.
+    template <typename Handler>
+    bool take_handler(uint32_t id, Handler& out);
+
+    // A pending request handler and the connection its request was sent on,
+    // which is unsent while the request is held by the window. A request
+    // with a key may be cached, if cacheable, and coalesced, in which case
+    // identical requests pending under the follower ids are answered with it.
+    struct pending_request
+    {
+        request_handler handler;
+        size_t connection;
+        std::chrono::steady_clock::time_point sent;
+        std::chrono::steady_clock::time_point deadline;
+        system::data_chunk key;
+        bool cacheable;
+        std::vector<uint32_t> followers;
+    };
+
+    static constexpr size_t unsent = system::max_size_t;
+
+    // A request held by the window, whose handler is already pending.
+    struct held_request
+    {
+        command type;
+        uint32_t id;
+        system::data_chunk payload;
+    };
+
+    typedef request_table<pending_request> request_handler_table;
+
+    // A request accepted by a fetcher, queued for the reactor if running.
+    struct submission
+    {
+        command type;
+        uint32_t id;
+        system::data_chunk payload;
+        request_handler handler;
+        uint32_t timeout_milliseconds;
+        system::data_chunk key;
+        bool cacheable;
+        response_cache::value cached;
+    };
+
+    // A cached response to a request, queued to be answered by the loop.
+    struct cached_answer
+    {
+        command type;
+        uint32_t id;
+        response_cache::value response;
+    };
+
+    // Allocates a request id and sends the request, or queues it for the
+    // reactor thread if running. A request with a key (see request_key) is
+    // coalesced into an identical request in flight, and its successful
+    // response is cached if cacheable. A request with a cached response is
+    // answered with it by the loop, and is not sent.
+    void submit(command type, system::data_chunk&& payload,
+        request_handler&& handler, uint32_t timeout_milliseconds,
+        system::data_chunk&& key={}, bool cacheable=false,
+        response_cache::value&& cached={});
+
+    // The response cached under the key, if the cache is set and the request
+    // is cacheable, otherwise null.
+    response_cache::value find_cached(const system::data_chunk& key,
+        bool cacheable);
+
+    // True if a response by the height is buried deep enough to cache.
+    bool buried(size_t height) const;
+
+    // Caches the response to the request id if it is cacheable. Called only by
+    // the loop that owns the request table, never for a subscription.
+    void cache_response(command type, uint32_t id,
+        const system::data_chunk& payload);
+
+    // Raises the highest height seen, which buries responses by height.
+    void observe_height(size_t height);
+
+    // Registers the handler of the request and sends it, or holds it if the
+    // window is full. An identical request in flight is joined instead, and
+    // a cached request is queued to be answered.
+    void dispatch(submission& request);
+
+    // Registers the handler of the request as a follower of the identical
+    // request in flight with the same handler type, if any.
+    bool coalesce(submission& request);
+
+    // Sends a registered request on the least loaded connection.
+    void transmit(command type, uint32_t id, const system::data_chunk& payload);
+
+    // Answers the queued cached requests, true if there were any.
+    bool answer_cached_requests();
+
+    // Sends held requests that still have handlers, as the window allows.
+    void release_requests();
+
+    // True if the window admits another request on the wire.
+    bool window_open() const;
+
+    // True if the connection admits another request under its limit.
+    bool admits(size_t connection) const;
+
+    // Sets the backlogged state and signals a change to the handler.
+    void set_backlogged(bool backlogged);
+
+    // Reactor thread loop and its submission queue handling.
+    void run_reactor();
+    void drain_submissions();
+    void ring_doorbell();
+
+    // Wakes monitor() when a block is parsed, if it has armed the bell.
+    void ring_monitor();
+
+    // Binds the bell that wakes monitor().
+    bool bind_monitor_bell();
+
+    // Passes fetched blocks to the sequencer, and invokes the block update
+    // handler with each parsed block that is next.
+    void deliver_blocks();
+
+    // Delivers a block of the feed to its handler, or to the decoder.
+    void deliver_block(system::data_chunk&& data);
+
+    // Fetches a block missed by the feed, for the sequencer.
+    void fetch_missing_block(size_t height);
+
+    // Reports a block that the sequencer could not fetch.
+    void fail_missing_block(size_t height);
+
+    // The state of a blockchain_fetch_blocks call, shared by its requests.
+    struct block_range;
+    typedef std::shared_ptr<block_range> block_range_ptr;
+
+    // Requests blocks of the range as its window allows.
+    void fetch_range_blocks(const block_range_ptr& range);
+
+    // Buffers a block of the range and delivers those next in order.
+    void handle_range_block(const block_range_ptr& range, size_t height,
+        const system::code& ec, const system::chain::block& block);
+
+    // Registers the handler of the request as pending (unsent), with a
+    // deadline if its timeout is nonzero.
+    void add_handler(submission& request);
+
+    // Adds a request connection with the security settings of socket_.
+    bool add_connection(const system::config::endpoint& address,
+        const system::config::authority& socks_proxy,
+        const protocol::zmq::sodium& server_public_key,
+        const protocol::zmq::sodium& client_private_key);
+
+    // The admitting request connection with the fewest unanswered requests.
+    size_t select_connection();
+
+    // Fails pending requests with expired deadlines.
+    void expire_requests();
+
     // Determines if any requests have not been handled.
     bool requests_outstanding();
 
@@ -242,16 +631,18 @@ private:
     // error.
     void clear_outstanding_subscribe_requests(const system::code& ec);
 
-    // Sends an outgoing request via the internal router.
-    bool send_request(const std::string& command, uint32_t id,
-        const system::data_chunk& payload, bool subscription=false);
-
     // Forward incoming client router requests to the server.
     void forward_message(protocol::zmq::socket& source,
         protocol::zmq::socket& sink);
 
-    // Process server responses.
-    void process_response(protocol::zmq::socket& socket);
+    // Forward an incoming client router request to its server connection.
+    void forward_request();
+
+    // Process server responses, caching them if read by the request loop.
+    void process_response(protocol::zmq::socket& socket, bool cache=false);
+
+    // Process server responses on any readable request connection.
+    void process_responses(const protocol::zmq::identifiers& identifiers);
 
     // After notifying the server of unsubscribe, this terminates any client
     // side monitoring state for the subscription.
@@ -276,30 +667,92 @@ private:
     protocol::zmq::socket subscribe_router_;
 
     block_update_handler on_block_update_;
+    block_view_update_handler on_block_view_update_;
     transaction_update_handler on_transaction_update_;
     int32_t retries_;
     bool secure_;
+    bool direct_send_;
     system::config::endpoint worker_;
     system::config::endpoint subscribe_worker_;
-    uint32_t last_request_index_;
+    std::atomic<uint32_t> last_request_index_;
     command_map command_handlers_;
-    result_handler_map result_handlers_;
-    height_handler_map height_handlers_;
-    transaction_index_handler_map transaction_index_handlers_;
-    block_handler_map block_handlers_;
-    block_header_handler_map block_header_handlers_;
-    compact_filter_handler_map compact_filter_handlers_;
-    compact_filter_checkpoint_handler_map compact_filter_checkpoint_handlers_;
-    compact_filter_headers_handler_map compact_filter_headers_handlers_;
-    transaction_handler_map transaction_handlers_;
-    history_handler_map history_handlers_;
+    request_handler_table request_handlers_;
+    timer_wheel request_timers_;
     subscription_handler_map subscription_handlers_;
     unsubscription_handler_map unsubscription_handlers_;
-    hash_list_handler_map hash_list_handlers_;
-    version_handler_map version_handlers_;
+
+    // Request connections, the first of which is socket_, with the count of
+    // unanswered requests sent on each and its adaptive limit.
+    std::vector<protocol::zmq::socket*> connections_;
+    std::vector<std::unique_ptr<protocol::zmq::socket>> pool_;
+    std::vector<size_t> outstanding_;
+    std::vector<adaptive_limit> limits_;
+    size_t next_connection_;
+    bool adaptive_;
+
+    // Requests held while the count of unanswered requests fills the window.
+    std::deque<held_request> held_requests_;
+
+    // Cached responses to requests, answered by the loop.
+    std::vector<cached_answer> cached_answers_;
+    size_t window_;
+    size_t in_flight_;
+    std::atomic<bool> backlogged_;
+    backpressure_handler on_backpressure_;
 
     // Protects subscription_handlers_
     system::upgrade_mutex subscription_lock_;
+
+    // Reactor thread state. Producers ring the doorbell only if the reactor
+    // has armed it, which it does just before blocking on its poll.
+    std::thread reactor_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stopping_;
+    std::atomic<bool> doorbell_armed_;
+    bool doorbell_bound_;
+    mpsc_queue<submission> submissions_;
+    protocol::zmq::socket doorbell_;
+    protocol::zmq::socket doorbell_sender_;
+
+    // Protects doorbell_sender_
+    std::mutex doorbell_lock_;
+
+    // Block feed workers, and the bell they ring as blocks are parsed, which
+    // monitor() arms just before delivering the parsed blocks.
+    std::unique_ptr<block_decoder> block_decoder_;
+    std::atomic<bool> monitor_bell_armed_;
+    bool monitor_bell_bound_;
+    protocol::zmq::socket monitor_bell_;
+    protocol::zmq::socket monitor_bell_sender_;
+
+    // Protects monitor_bell_sender_
+    std::mutex monitor_bell_lock_;
+
+    // Block feed ordering, and blocks fetched for it that are not yet
+    // passed to it by monitor().
+    bool sequence_blocks_;
+    block_sequencer block_sequencer_;
+    feed_gap_handler on_block_gap_;
+    std::vector<std::pair<size_t, system::data_chunk>> backfilled_;
+
+    // Protects backfilled_
+    std::mutex backfill_lock_;
+
+    // The next expected transaction feed sequence, once one is received.
+    feed_gap_handler on_transaction_gap_;
+    uint16_t transaction_sequence_;
+    bool transaction_sequenced_;
+
+    // Responses that do not change, and the highest height seen, below
+    // which those by height are cached.
+    std::unique_ptr<response_cache> cache_;
+    size_t cache_depth_;
+    std::atomic<size_t> top_height_;
+
+    // The id of the request in flight for each request key, which identical
+    // requests join rather than being sent.
+    std::unordered_map<system::data_chunk, uint32_t,
+        response_cache::key_hash> coalescing_;
 };
 
 } // namespace client
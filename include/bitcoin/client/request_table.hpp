@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_REQUEST_TABLE_HPP
+#define LIBBITCOIN_CLIENT_REQUEST_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Table of pending requests indexed by request id.
+/// Request ids are allocated sequentially, so live ids fall within a window
+/// that maps onto a power of two ring of slots (id modulo capacity). This
+/// provides constant time insert, find and erase with no per-request node
+/// allocation. The ring doubles when a live id would be displaced, up to
+/// maximum_capacity, beyond which the displaced (older) entry is moved to an
+/// overflow map. The ring halves, down to its constructed capacity, once it
+/// has stayed under a quarter full for as many removals as it has slots,
+/// and only if no live ids would then collide. Halving is suspended once a
+/// halved ring has doubled again, until the table empties, so that a long
+/// lived entry cannot cause the ring to alternate. This is not thread safe.
+template <typename Value>
+class request_table
+{
+public:
+    static constexpr size_t default_capacity = 64;
+    static constexpr size_t maximum_capacity = 1u << 20;
+
+    /// Capacity is rounded up to a power of two.
+    request_table(size_t capacity=default_capacity);
+
+    /// Add the value under id, false if the id is already present.
+    bool insert(uint32_t id, Value value);
+
+    /// The value under id, or nullptr if not present.
+    Value* find(uint32_t id);
+
+    /// Move out the value under id and remove it, false if not present.
+    bool take(uint32_t id, Value& out);
+
+    /// Remove the value under id, false if not present.
+    bool erase(uint32_t id);
+
+    /// Remove all values, invoking visitor(id, value) for each.
+    /// Values inserted by the visitor are retained.
+    template <typename Visitor>
+    void drain(Visitor visitor);
+
+    /// The number of values present.
+    size_t size() const;
+
+    /// True if no values are present.
+    bool empty() const;
+
+    /// The number of slots in the ring.
+    size_t capacity() const;
+
+private:
+    struct slot
+    {
+        uint32_t id;
+        bool used;
+        Value value;
+    };
+
+    typedef std::vector<slot> slots;
+    typedef std::unordered_map<uint32_t, Value> overflow;
+
+    size_t index(uint32_t id) const;
+    void grow();
+    void shrink();
+
+    slots slots_;
+    overflow overflow_;
+    size_t mask_;
+    size_t size_;
+    size_t minimum_;
+    size_t sparse_removals_;
+    bool shrunk_;
+    bool regrown_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#include <bitcoin/client/impl/request_table.ipp>
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_RESPONSE_CACHE_HPP
+#define LIBBITCOIN_CLIENT_RESPONSE_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/system.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Serialized responses keyed by their serialized requests, within a budget
+/// of bytes. Entries are spread over shards by key, each with its own lock
+/// and least recently used order, and an even share of the budget. There
+/// are only as many shards as have a share of at least minimum_share, so
+/// that the largest blocks are cached within a small budget, and a response
+/// larger than a share is not cached. Responses are shared, so that a hit is
+/// not copied under the lock. This is thread safe.
+class BCC_API response_cache
+{
+public:
+    typedef system::data_chunk key;
+    typedef std::shared_ptr<const system::data_chunk> value;
+
+    static constexpr size_t default_shards = 16;
+
+    /// The least share of a shard, twice the largest serialized block.
+    static constexpr size_t minimum_share = 8u * 1024u * 1024u;
+
+    /// Hashes a key, for other maps keyed by request.
+    struct key_hash
+    {
+        size_t operator()(const key& request) const;
+    };
+
+    /// The shards are fewer if the budget has too few minimum shares.
+    response_cache(size_t budget_bytes, size_t shards=default_shards);
+
+    /// The response cached under the key, or null, counted as hit or miss.
+    value find(const key& request);
+
+    /// Cache the response under the key, evicting the least recently used
+    /// entries of its shard to stay within budget.
+    void store(key&& request, const system::data_chunk& response);
+
+    /// Drop all entries, retaining the counters.
+    void clear();
+
+    /// The number of finds that returned a response.
+    size_t hits() const;
+
+    /// The number of finds that did not.
+    size_t misses() const;
+
+    /// The number of cached responses.
+    size_t size() const;
+
+    /// The bytes charged to cached responses, including overhead.
+    size_t bytes() const;
+
+    /// The number of shards.
+    size_t shards() const;
+
+private:
+    struct entry
+    {
+        key request;
+        value response;
+    };
+
+    typedef std::list<entry> entries;
+
+    // Entries from most to least recently used, indexed by key.
+    struct shard
+    {
+        mutable std::mutex mutex;
+        entries order;
+        std::unordered_map<key, entries::iterator, key_hash> index;
+        size_t bytes = 0;
+    };
+
+    static size_t charge(const key& request, const system::data_chunk& data);
+    shard& select(const key& request);
+
+    const size_t share_;
+    std::vector<shard> shards_;
+    std::atomic<size_t> hits_;
+    std::atomic<size_t> misses_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
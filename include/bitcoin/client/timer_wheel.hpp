@@ -0,0 +1,102 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_TIMER_WHEEL_HPP
+#define LIBBITCOIN_CLIENT_TIMER_WHEEL_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/client/command.hpp>
+#include <bitcoin/client/define.hpp>
+
+namespace libbitcoin {
+namespace client {
+
+/// Hierarchical timing wheel of request deadlines, in millisecond ticks.
+/// Each level divides the span of the level above into 64 slots, so four
+/// levels cover 2^24 ms (about 4.6 hours), with later deadlines held in an
+/// overflow list until they come into range. Scheduling is constant time and
+/// each timer is moved at most once per level before it expires.
+/// Cancellation is lazy: a timer for a completed request expires as usual
+/// and must be ignored by the caller. This is not thread safe.
+class BCC_API timer_wheel
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    struct timer
+    {
+        uint32_t id;
+        command type;
+        uint64_t tick;
+    };
+
+    typedef std::vector<timer> timers;
+
+    static constexpr size_t level_bits = 6;
+    static constexpr size_t slot_count = 1u << level_bits;
+    static constexpr size_t level_count = 4;
+
+    /// Ticks are counted in milliseconds from start.
+    timer_wheel(clock::time_point start=clock::now());
+
+    /// Schedule expiry of the request at deadline (rounded up to a tick).
+    void schedule(uint32_t id, command type, clock::time_point deadline);
+
+    /// Advance to now, appending all timers that have expired to expired.
+    /// Ticks at which no timer expires or cascades are skipped.
+    void advance(clock::time_point now, timers& expired);
+
+    /// A time at or before the next expiry, max() if no timers.
+    clock::time_point next_expiry() const;
+
+    /// Remove all timers.
+    void clear();
+
+    /// The number of scheduled timers.
+    size_t size() const;
+
+    /// True if no timers are scheduled.
+    bool empty() const;
+
+private:
+    typedef std::array<timers, slot_count> level;
+
+    uint64_t to_tick(clock::time_point time, bool round_up) const;
+    clock::time_point to_time(uint64_t tick) const;
+    uint64_t next_tick() const;
+    void insert(const timer& entry);
+    void cascade(timers& slot);
+    void expire(timers& slot, timers& expired);
+    void step(timers& expired);
+
+    const clock::time_point start_;
+    uint64_t current_;
+    size_t size_;
+    std::array<level, level_count> levels_;
+    timers due_;
+    timers overflow_;
+};
+
+} // namespace client
+} // namespace libbitcoin
+
+#endif
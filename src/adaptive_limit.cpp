@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/adaptive_limit.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace libbitcoin {
+namespace client {
+
+// Round trips within this multiple of the baseline are not queueing.
+static constexpr double tolerance = 2.0;
+
+// The weight of each adjustment, which damps noise in the samples.
+static constexpr double smoothing = 0.2;
+
+// The multiplicative decrease for a request that was not answered in time.
+static constexpr double backoff = 0.9;
+
+// The number of samples after which the baseline is taken afresh.
+static constexpr size_t baseline_window = 100;
+
+adaptive_limit::adaptive_limit(size_t initial, size_t minimum, size_t maximum)
+  : minimum_(static_cast<double>(std::max<size_t>(minimum, 1))),
+    maximum_(std::max(static_cast<double>(maximum), minimum_)),
+    limit_(minimum_),
+    baseline_(duration::max()),
+    window_minimum_(duration::max()),
+    window_samples_(0)
+{
+    set(static_cast<double>(initial));
+}
+
+size_t adaptive_limit::limit() const
+{
+    return static_cast<size_t>(limit_);
+}
+
+void adaptive_limit::sample(const duration& round_trip, size_t in_flight)
+{
+    const auto trip = std::max(round_trip, duration(1));
+    baseline_ = std::min(baseline_, trip);
+    window_minimum_ = std::min(window_minimum_, trip);
+
+    if (++window_samples_ == baseline_window)
+    {
+        baseline_ = window_minimum_;
+        window_minimum_ = duration::max();
+        window_samples_ = 0;
+    }
+
+    const auto gradient = std::clamp(tolerance *
+        static_cast<double>(baseline_.count()) /
+        static_cast<double>(trip.count()), 0.5, 1.0);
+
+    // An application limited connection says nothing of spare capacity.
+    if (gradient == 1.0 && static_cast<double>(in_flight) < limit_ / 2)
+        return;
+
+    const auto target = limit_ * gradient + std::sqrt(limit_);
+    set((1.0 - smoothing) * limit_ + smoothing * target);
+}
+
+void adaptive_limit::drop()
+{
+    set(limit_ * backoff);
+}
+
+void adaptive_limit::set(double limit)
+{
+    limit_ = std::clamp(limit, minimum_, maximum_);
+}
+
+} // namespace client
+} // namespace libbitcoin
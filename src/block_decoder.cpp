@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/block_decoder.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+
+block_decoder::block_decoder(size_t threads, notify_handler notify,
+    bool witness)
+  : witness_(witness),
+    notify_(std::move(notify)),
+    pushed_(0),
+    delivered_(0),
+    stopping_(false)
+{
+    const auto count = std::max<size_t>(threads, 1);
+    workers_.reserve(count);
+
+    for (size_t thread = 0; thread < count; ++thread)
+        workers_.emplace_back(&block_decoder::work, this);
+}
+
+block_decoder::~block_decoder()
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    queued_.notify_all();
+
+    for (auto& worker: workers_)
+        worker.join();
+}
+
+void block_decoder::push(data_chunk&& data)
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back({ pushed_++, std::move(data) });
+        results_.push_back({ false, {} });
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    queued_.notify_one();
+}
+
+size_t block_decoder::deliver(const block_handler& handler)
+{
+    std::vector<block> blocks;
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        while (!results_.empty() && results_.front().parsed)
+        {
+            blocks.push_back(std::move(results_.front().block));
+            results_.pop_front();
+            ++delivered_;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Handlers are invoked outside of the lock, so workers are not stalled.
+    for (const auto& block: blocks)
+        handler(block);
+
+    return blocks.size();
+}
+
+size_t block_decoder::pending() const
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+    return results_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void block_decoder::work()
+{
+    while (true)
+    {
+        job next;
+
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queued_.wait(lock, [this]()
+            {
+                return stopping_ || !jobs_.empty();
+            });
+
+            if (stopping_)
+                return;
+
+            next = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        // Parsing, the expensive part, runs concurrently across workers.
+        block parsed;
+        parsed.from_data(next.data, witness_);
+
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto& out = results_[next.ordinal - delivered_];
+            out.block = std::move(parsed);
+            out.parsed = true;
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        if (notify_)
+            notify_();
+    }
+}
+
+} // namespace client
+} // namespace libbitcoin
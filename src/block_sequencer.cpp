@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/block_sequencer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+
+namespace libbitcoin {
+namespace client {
+
+block_sequencer::block_sequencer(fetch_handler fetch,
+    deliver_handler deliver, size_t window, failure_handler failed,
+    size_t retries)
+  : fetch_(std::move(fetch)),
+    deliver_(std::move(deliver)),
+    failed_(std::move(failed)),
+    window_(std::max<size_t>(window, 1)),
+    retries_(retries),
+    tracking_(false),
+    last_(0),
+    next_(1),
+    top_(0),
+    in_flight_(0)
+{
+}
+
+void block_sequencer::track(size_t last_height)
+{
+    tracking_ = true;
+    last_ = last_height;
+}
+
+void block_sequencer::backfill(size_t top_height)
+{
+    if (!tracking_ || top_height <= last_)
+        return;
+
+    // Heights already requested are not requested again.
+    if (backfilling())
+    {
+        top_ = std::max(top_, top_height);
+    }
+    else
+    {
+        next_ = last_ + 1u;
+        top_ = top_height;
+    }
+
+    request();
+}
+
+void block_sequencer::live(size_t height, data_chunk&& data)
+{
+    if (!tracking_)
+    {
+        tracking_ = true;
+        deliver(height, std::move(data));
+        return;
+    }
+
+    // Gaps between held blocks are filled as they are released. Heights
+    // that exceeded their retries are fetched again, as the server has moved.
+    if (backfilling())
+    {
+        held_.emplace_back(height, std::move(data));
+
+        auto parked = std::move(parked_);
+        parked_.clear();
+        for (const auto missing: parked)
+        {
+            ++in_flight_;
+            fetch_(missing);
+        }
+
+        return;
+    }
+
+    if (height > last_ + 1u)
+    {
+        held_.emplace_back(height, std::move(data));
+        backfill(height - 1u);
+        return;
+    }
+
+    deliver(height, std::move(data));
+}
+
+// A failed height is fetched again, as it cannot be delivered without, but
+// after a delay, so that a height above the server's top or a persistent
+// server error does not become a request loop.
+void block_sequencer::fetched(size_t height, data_chunk&& data)
+{
+    if (in_flight_ > 0)
+        --in_flight_;
+
+    if (data.empty())
+    {
+        if (height <= last_)
+            return;
+
+        const auto failures = ++failures_[height];
+        if (failures > retries_)
+        {
+            failures_.erase(height);
+            parked_.insert(height);
+
+            if (failed_)
+                failed_(height);
+
+            return;
+        }
+
+        const auto doublings = std::min<size_t>(failures - 1u, 16u);
+        retries_due_[height] = clock::now() + retry_delay * (1u << doublings);
+        return;
+    }
+
+    failures_.erase(height);
+    if (height > last_)
+        fetched_[height] = std::move(data);
+
+    drain();
+}
+
+// Due heights are collected first, as a fetch may fail within the handler.
+void block_sequencer::retry(clock::time_point now)
+{
+    std::vector<size_t> due;
+    for (auto it = retries_due_.begin(); it != retries_due_.end();)
+    {
+        if (it->second <= now)
+        {
+            due.push_back(it->first);
+            it = retries_due_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto height: due)
+    {
+        ++in_flight_;
+        fetch_(height);
+    }
+}
+
+block_sequencer::clock::time_point block_sequencer::next_retry() const
+{
+    auto next = clock::time_point::max();
+    for (const auto& due: retries_due_)
+        next = std::min(next, due.second);
+
+    return next;
+}
+
+bool block_sequencer::backfilling() const
+{
+    return next_ <= top_ || in_flight_ > 0 || !fetched_.empty() ||
+        !retries_due_.empty() || !parked_.empty();
+}
+
+bool block_sequencer::tracking() const
+{
+    return tracking_;
+}
+
+size_t block_sequencer::last_height() const
+{
+    return last_;
+}
+
+void block_sequencer::deliver(size_t height, data_chunk&& data)
+{
+    last_ = height;
+    deliver_(height, std::move(data));
+}
+
+// Heights are requested only within the window above the last delivered,
+// which bounds those fetched but not yet deliverable.
+void block_sequencer::request()
+{
+    while (next_ <= top_ && next_ <= last_ + window_)
+    {
+        ++in_flight_;
+        fetch_(next_++);
+    }
+}
+
+// Deliver fetched blocks that are next in height, then release held feed
+// blocks once nothing remains to be fetched.
+void block_sequencer::drain()
+{
+    auto it = fetched_.begin();
+    while (it != fetched_.end() && it->first <= last_ + 1u)
+    {
+        if (it->first == last_ + 1u)
+            deliver(it->first, std::move(it->second));
+
+        it = fetched_.erase(it);
+    }
+
+    request();
+    if (backfilling())
+        return;
+
+    // A held block may begin another backfill, which holds those after it.
+    auto held = std::move(held_);
+    held_.clear();
+
+    for (auto& block: held)
+        live(block.first, std::move(block.second));
+}
+
+} // namespace client
+} // namespace libbitcoin
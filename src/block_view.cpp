@@ -0,0 +1,331 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/block_view.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+
+// The witness marker and flag that follow the version of a witness
+// transaction, where a transaction without witness has its input count.
+static constexpr uint8_t witness_marker = 0x00;
+static constexpr uint8_t witness_flag = 0x01;
+
+// Sizes of the fixed width fields skipped over in a transaction.
+static constexpr size_t version_size = sizeof(uint32_t);
+static constexpr size_t locktime_size = sizeof(uint32_t);
+static constexpr size_t sequence_size = sizeof(uint32_t);
+static constexpr size_t value_size = sizeof(uint64_t);
+static constexpr size_t outpoint_size = hash_size + sizeof(uint32_t);
+
+// An input stream over a range of the buffer, which it does not copy.
+class range_buffer
+  : public std::streambuf
+{
+public:
+    range_buffer(const uint8_t* begin, const uint8_t* end)
+    {
+        const auto first = const_cast<char*>(
+            reinterpret_cast<const char*>(begin));
+        setg(first, first, first + (end - begin));
+    }
+};
+
+static bool skip(const data_chunk& data, size_t& offset, uint64_t bytes)
+{
+    if (bytes > data.size() - offset)
+        return false;
+
+    offset += static_cast<size_t>(bytes);
+    return true;
+}
+
+static bool read_variable(const data_chunk& data, size_t& offset,
+    uint64_t& out)
+{
+    if (offset == data.size())
+        return false;
+
+    const auto prefix = data[offset++];
+    const auto bytes = data.data() + offset;
+
+    switch (prefix)
+    {
+        case 0xfd:
+            if (!skip(data, offset, sizeof(uint16_t)))
+                return false;
+            out = from_little_endian_unsafe<uint16_t>(bytes);
+            return true;
+        case 0xfe:
+            if (!skip(data, offset, sizeof(uint32_t)))
+                return false;
+            out = from_little_endian_unsafe<uint32_t>(bytes);
+            return true;
+        case 0xff:
+            if (!skip(data, offset, sizeof(uint64_t)))
+                return false;
+            out = from_little_endian_unsafe<uint64_t>(bytes);
+            return true;
+        default:
+            out = prefix;
+            return true;
+    }
+}
+
+// Skip a length prefixed field, such as a script or witness element.
+static bool skip_variable(const data_chunk& data, size_t& offset)
+{
+    uint64_t bytes;
+    return read_variable(data, offset, bytes) && skip(data, offset, bytes);
+}
+
+// Advance the offset over the transaction, without parsing its fields.
+static bool skip_transaction(const data_chunk& data, size_t& offset,
+    bool witness)
+{
+    if (!skip(data, offset, version_size))
+        return false;
+
+    const auto segregated = witness && data.size() - offset >= 2 &&
+        data[offset] == witness_marker && data[offset + 1] == witness_flag;
+
+    if (segregated)
+        offset += 2;
+
+    uint64_t inputs;
+    if (!read_variable(data, offset, inputs))
+        return false;
+
+    for (uint64_t input = 0; input < inputs; ++input)
+        if (!skip(data, offset, outpoint_size) ||
+            !skip_variable(data, offset) ||
+            !skip(data, offset, sequence_size))
+            return false;
+
+    uint64_t outputs;
+    if (!read_variable(data, offset, outputs))
+        return false;
+
+    for (uint64_t output = 0; output < outputs; ++output)
+        if (!skip(data, offset, value_size) ||
+            !skip_variable(data, offset))
+            return false;
+
+    if (segregated)
+    {
+        for (uint64_t input = 0; input < inputs; ++input)
+        {
+            uint64_t elements;
+            if (!read_variable(data, offset, elements))
+                return false;
+
+            for (uint64_t element = 0; element < elements; ++element)
+                if (!skip_variable(data, offset))
+                    return false;
+        }
+    }
+
+    return skip(data, offset, locktime_size);
+}
+
+// block_view::const_iterator
+// ----------------------------------------------------------------------------
+
+block_view::const_iterator::const_iterator(const block_view& view,
+    size_t index)
+  : view_(&view), index_(index)
+{
+}
+
+transaction block_view::const_iterator::operator*() const
+{
+    return view_->transaction(index_);
+}
+
+block_view::const_iterator& block_view::const_iterator::operator++()
+{
+    ++index_;
+    return *this;
+}
+
+block_view::const_iterator block_view::const_iterator::operator++(int)
+{
+    auto copy = *this;
+    ++index_;
+    return copy;
+}
+
+bool block_view::const_iterator::operator==(
+    const const_iterator& other) const
+{
+    return view_ == other.view_ && index_ == other.index_;
+}
+
+bool block_view::const_iterator::operator!=(
+    const const_iterator& other) const
+{
+    return !(*this == other);
+}
+
+// block_view
+// ----------------------------------------------------------------------------
+
+block_view::block_view()
+  : offset_(0), witness_(false), valid_(false), count_(0), truncated_(true)
+{
+}
+
+block_view::block_view(data_chunk&& data, bool witness)
+  : block_view(std::make_shared<const data_chunk>(std::move(data)), 0,
+        witness)
+{
+}
+
+block_view::block_view(buffer_ptr buffer, size_t offset, bool witness)
+  : buffer_(std::move(buffer)), offset_(offset), witness_(witness),
+    valid_(false), count_(0), truncated_(true)
+{
+    if (!buffer_ || offset_ > buffer_->size() ||
+        buffer_->size() - offset_ < header::satoshi_fixed_size())
+        return;
+
+    const auto begin = buffer_->data() + offset_;
+    range_buffer range(begin, begin + header::satoshi_fixed_size());
+    std::istream stream(&range);
+    istream_reader source(stream);
+    if (!header_.from_data(source))
+        return;
+
+    auto position = offset_ + header::satoshi_fixed_size();
+    uint64_t count;
+    if (!read_variable(*buffer_, position, count))
+        return;
+
+    // A transaction is at least ten bytes, which bounds a corrupt count.
+    if (count > (buffer_->size() - position) / 10u)
+        return;
+
+    count_ = static_cast<size_t>(count);
+    offsets_.push_back(position);
+    truncated_ = false;
+    valid_ = true;
+}
+
+bool block_view::is_valid() const
+{
+    return valid_;
+}
+
+const header& block_view::header() const
+{
+    return header_;
+}
+
+size_t block_view::size() const
+{
+    return count_;
+}
+
+// Locate transactions in order up to the one following the index, so that
+// each is bounded by its own offset and the next.
+bool block_view::locate(size_t index) const
+{
+    if (index >= count_)
+        return false;
+
+    while (offsets_.size() <= index + 1u && !truncated_)
+    {
+        auto offset = offsets_.back();
+        if (skip_transaction(*buffer_, offset, witness_))
+            offsets_.push_back(offset);
+        else
+            truncated_ = true;
+    }
+
+    return offsets_.size() > index + 1u;
+}
+
+transaction block_view::transaction(size_t index) const
+{
+    chain::transaction out;
+    if (!locate(index))
+        return out;
+
+    const auto begin = buffer_->data();
+    range_buffer range(begin + offsets_[index], begin + offsets_[index + 1u]);
+    std::istream stream(&range);
+    istream_reader source(stream);
+    out.from_data(source, true, witness_);
+    return out;
+}
+
+data_chunk block_view::transaction_data(size_t index) const
+{
+    if (!locate(index))
+        return {};
+
+    const auto begin = buffer_->begin();
+    return { begin + offsets_[index], begin + offsets_[index + 1u] };
+}
+
+block_view::const_iterator block_view::begin() const
+{
+    return { *this, 0 };
+}
+
+block_view::const_iterator block_view::end() const
+{
+    return { *this, count_ };
+}
+
+block block_view::to_block() const
+{
+    block out;
+    if (!valid_)
+        return out;
+
+    const auto begin = buffer_->data();
+    range_buffer range(begin + offset_, begin + buffer_->size());
+    std::istream stream(&range);
+    istream_reader source(stream);
+    out.from_data(source, witness_);
+    return out;
+}
+
+data_slice block_view::data() const
+{
+    if (!buffer_ || offset_ > buffer_->size())
+        return {};
+
+    const auto begin = buffer_->data();
+    return { begin + offset_, begin + buffer_->size() };
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/command.hpp>
+
+#include <array>
+#include <cstring>
+
+using namespace bc::system;
+
+namespace libbitcoin {
+namespace client {
+
+typedef std::array<std::string, command_count + 1> name_table;
+typedef std::array<data_chunk, command_count + 1> frame_table;
+
+// Ordered as the command enumeration, terminated by the unknown command.
+static const name_table& names()
+{
+    static const name_table table
+    {
+        {
+            "transaction_pool.broadcast",
+            "transaction_pool.validate2",
+            "transaction_pool.fetch_transaction",
+            "transaction_pool.fetch_transaction2",
+            "blockchain.broadcast",
+            "blockchain.validate",
+            "blockchain.fetch_transaction",
+            "blockchain.fetch_transaction2",
+            "blockchain.fetch_last_height",
+            "blockchain.fetch_block",
+            "blockchain.fetch_block_header",
+            "blockchain.fetch_block_height",
+            "blockchain.fetch_compact_filter",
+            "blockchain.fetch_compact_filter_checkpoint",
+            "blockchain.fetch_compact_filter_headers",
+            "blockchain.fetch_transaction_index",
+            "blockchain.fetch_history4",
+            "blockchain.fetch_block_transaction_hashes",
+            "subscribe.key",
+            "notification.key",
+            "unsubscribe.key",
+            "server.version",
+            ""
+        }
+    };
+
+    return table;
+}
+
+static const frame_table& frames()
+{
+    static const frame_table table = []()
+    {
+        frame_table built;
+        for (size_t index = 0; index < built.size(); ++index)
+            built[index] = to_chunk(names()[index]);
+
+        return built;
+    }();
+
+    return table;
+}
+
+static size_t to_index(command type)
+{
+    const auto index = static_cast<size_t>(type);
+    return index < command_count ? index : command_count;
+}
+
+const std::string& command_name(command type)
+{
+    return names()[to_index(type)];
+}
+
+const data_chunk& command_frame(command type)
+{
+    return frames()[to_index(type)];
+}
+
+// The frame length excludes most candidates before any bytes are compared.
+command to_command(const data_slice& frame)
+{
+    const auto& table = names();
+    const auto size = frame.size();
+
+    for (size_t index = 0; index < command_count; ++index)
+    {
+        const auto& name = table[index];
+        if (name.size() == size &&
+            std::memcmp(name.data(), frame.data(), size) == 0)
+            return static_cast<command>(index);
+    }
+
+    return command::unknown;
+}
+
+} // namespace client
+} // namespace libbitcoin
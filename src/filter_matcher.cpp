@@ -0,0 +1,426 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/filter_matcher.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+
+namespace libbitcoin {
+namespace client {
+
+// Filters are claimed by workers in runs, so that they rarely contend.
+static constexpr size_t run_size = 64;
+
+// Fewer hashes than this are sorted by comparison.
+static constexpr size_t radix_minimum = 256;
+static constexpr size_t radix_bits = 11;
+
+static uint64_t load_little_endian(const uint8_t* data)
+{
+    uint64_t value = 0;
+    for (auto byte = 8u; byte > 0u; --byte)
+        value = (value << 8) | data[byte - 1u];
+
+    return value;
+}
+
+static uint64_t load_big_endian(const uint8_t* data)
+{
+    uint64_t value = 0;
+    for (auto byte = 0u; byte < 8u; ++byte)
+        value = (value << 8) | data[byte];
+
+    return value;
+}
+
+// SipHash-2-4, the hash of filter items (BIP158).
+static uint64_t siphash24(uint64_t key0, uint64_t key1, const uint8_t* data,
+    size_t size)
+{
+    uint64_t v0 = 0x736f6d6570736575 ^ key0;
+    uint64_t v1 = 0x646f72616e646f6d ^ key1;
+    uint64_t v2 = 0x6c7967656e657261 ^ key0;
+    uint64_t v3 = 0x7465646279746573 ^ key1;
+
+    const auto round = [&]()
+    {
+        v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; v0 = std::rotl(v0, 32);
+        v2 += v3; v3 = std::rotl(v3, 16); v3 ^= v2;
+        v0 += v3; v3 = std::rotl(v3, 21); v3 ^= v0;
+        v2 += v1; v1 = std::rotl(v1, 17); v1 ^= v2; v2 = std::rotl(v2, 32);
+    };
+
+    const auto compress = [&](uint64_t word)
+    {
+        v3 ^= word;
+        round();
+        round();
+        v0 ^= word;
+    };
+
+    const auto words = data + (size & ~size_t{ 7 });
+    for (; data != words; data += 8)
+        compress(load_little_endian(data));
+
+    // The last word holds the remaining bytes and the low byte of the size.
+    auto last = static_cast<uint64_t>(size) << 56;
+    for (size_t byte = 0; byte < (size & 7u); ++byte)
+        last |= static_cast<uint64_t>(data[byte]) << (8u * byte);
+
+    compress(last);
+
+    v2 ^= 0xff;
+    round();
+    round();
+    round();
+    round();
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// The high word of the product, which maps a hash uniformly into a range.
+static uint64_t multiply_high(uint64_t left, uint64_t right)
+{
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(left) *
+        right) >> 64);
+#else
+    const auto left_low = left & 0xffffffff;
+    const auto left_high = left >> 32;
+    const auto right_low = right & 0xffffffff;
+    const auto right_high = right >> 32;
+    const auto low = left_low * right_low;
+    const auto middle = left_high * right_low;
+    const auto cross = (low >> 32) + (middle & 0xffffffff) +
+        left_low * right_high;
+
+    return left_high * right_high + (middle >> 32) + (cross >> 32);
+#endif
+}
+
+// Sorts hashes less than the range by their bits, radix_bits at a time from
+// the least significant. A filter range is the item count times the rate,
+// so hashes of filters of up to 2^24 items sort in four passes.
+static void radix_sort(std::vector<uint64_t>& hashes,
+    std::vector<uint64_t>& buffer, uint64_t range)
+{
+    constexpr size_t buckets = size_t{ 1 } << radix_bits;
+    constexpr uint64_t mask = buckets - 1u;
+    std::array<size_t, buckets> offsets;
+
+    buffer.resize(hashes.size());
+    const auto width = static_cast<size_t>(std::bit_width(range));
+    for (size_t shift = 0; shift < width; shift += radix_bits)
+    {
+        offsets.fill(0);
+        for (const auto hash: hashes)
+            ++offsets[(hash >> shift) & mask];
+
+        size_t offset = 0;
+        for (auto& bucket: offsets)
+            offset += std::exchange(bucket, offset);
+
+        for (const auto hash: hashes)
+            buffer[offsets[(hash >> shift) & mask]++] = hash;
+
+        hashes.swap(buffer);
+    }
+}
+
+// The number of items of the filter, a compact size, and its byte length.
+static bool read_count(const uint8_t* data, size_t size, uint64_t& out,
+    size_t& length)
+{
+    if (size == 0)
+        return false;
+
+    const auto prefix = data[0];
+    length = prefix < 0xfd ? 1u : prefix == 0xfd ? 3u : prefix == 0xfe ? 5u :
+        9u;
+
+    if (size < length)
+        return false;
+
+    out = length == 1u ? prefix : 0u;
+    for (auto byte = length - 1u; byte > 0u; --byte)
+        out = (out << 8) | data[byte];
+
+    return true;
+}
+
+// Reads bits most significant first from a left aligned buffer. While a
+// word remains the buffer is refilled with a single unaligned load, so that
+// reads do not branch per bit or per byte. Bits beyond the count are those
+// that follow, and are read again unchanged by the next refill.
+class bit_reader
+{
+public:
+    bit_reader(const uint8_t* begin, const uint8_t* end)
+      : next_(begin), end_(end), buffer_(0), bits_(0)
+    {
+    }
+
+    // Ones terminated by a zero, false if the data ends first.
+    bool read_unary(uint64_t& out)
+    {
+        out = 0;
+        while (true)
+        {
+            refill();
+            const auto ones = static_cast<size_t>(std::countl_one(buffer_));
+            if (ones < bits_)
+            {
+                out += ones;
+                skip(ones + 1u);
+                return true;
+            }
+
+            if (bits_ == 0u)
+                return false;
+
+            out += bits_;
+            skip(bits_);
+        }
+    }
+
+    // Up to 56 bits, false if the data ends first.
+    bool read_bits(uint64_t& out, size_t count)
+    {
+        refill();
+        if (bits_ < count)
+            return false;
+
+        out = buffer_ >> (64u - count);
+        skip(count);
+        return true;
+    }
+
+private:
+    // Fills the buffer to at least 56 bits, or to the end of the data, and
+    // to at most 63 bits so that a skip never shifts out the whole word.
+    void refill()
+    {
+        if (end_ - next_ >= 8)
+        {
+            buffer_ |= load_big_endian(next_) >> bits_;
+            next_ += (63u - bits_) >> 3;
+            bits_ |= 56u;
+            return;
+        }
+
+        for (; bits_ < 56u && next_ != end_; bits_ += 8u)
+            buffer_ |= static_cast<uint64_t>(*next_++) << (56u - bits_);
+    }
+
+    void skip(size_t count)
+    {
+        buffer_ <<= count;
+        bits_ -= count;
+    }
+
+    const uint8_t* next_;
+    const uint8_t* const end_;
+    uint64_t buffer_;
+    size_t bits_;
+};
+
+uint64_t filter_matcher::siphash(const hash_digest& block_hash,
+    const data_chunk& item)
+{
+    return siphash24(load_little_endian(block_hash.data()),
+        load_little_endian(block_hash.data() + 8), item.data(), item.size());
+}
+
+filter_matcher::filter_matcher(const data_stack& items)
+  : items_(items)
+{
+}
+
+size_t filter_matcher::size() const
+{
+    return items_.size();
+}
+
+bool filter_matcher::match(const hash_digest& block_hash,
+    const data_chunk& filter) const
+{
+    return match(block_hash, filter.data(), filter.size());
+}
+
+bool filter_matcher::match(const hash_digest& block_hash,
+    const uint8_t* filter, size_t size) const
+{
+    scratch space;
+    return match(block_hash, filter, size, space);
+}
+
+std::vector<size_t> filter_matcher::match(
+    const std::vector<message::compact_filter>& filters,
+    size_t threads) const
+{
+    return match_all(filters.size(), threads,
+        [&filters](size_t index, hash_digest& hash, const uint8_t*& data,
+            size_t& size)
+        {
+            const auto& filter = filters[index];
+            hash = filter.block_hash();
+            data = filter.filter().data();
+            size = filter.filter().size();
+            return true;
+        });
+}
+
+std::vector<size_t> filter_matcher::match(const filter_store& store,
+    size_t first, size_t last, size_t threads) const
+{
+    if (first >= store.size() || first > last)
+        return {};
+
+    last = std::min(last, store.size() - 1u);
+
+    auto heights = match_all(last - first + 1u, threads,
+        [&store, first](size_t index, hash_digest& hash, const uint8_t*& data,
+            size_t& size)
+        {
+            data = store.filter_data(first + index, size);
+            return data != nullptr && store.block_hash(hash, first + index);
+        });
+
+    for (auto& height: heights)
+        height += first;
+
+    return heights;
+}
+
+// The items are hashed into the range of the filter and sorted, so that
+// the set is decoded only as far as the greatest item.
+bool filter_matcher::match(const hash_digest& block_hash,
+    const uint8_t* filter, size_t size, scratch& space) const
+{
+    uint64_t count;
+    size_t length;
+    if (items_.empty() || filter == nullptr ||
+        !read_count(filter, size, count, length) || count == 0u ||
+        count > max_uint32)
+        return false;
+
+    const auto range = count * golomb_rate;
+    const auto key0 = load_little_endian(block_hash.data());
+    const auto key1 = load_little_endian(block_hash.data() + 8);
+
+    auto& hashes = space.hashes;
+    hashes.clear();
+    for (const auto& item: items_)
+        hashes.push_back(multiply_high(siphash24(key0, key1, item.data(),
+            item.size()), range));
+
+    if (hashes.size() < radix_minimum)
+        std::sort(hashes.begin(), hashes.end());
+    else
+        radix_sort(hashes, space.buffer, range);
+
+    bit_reader reader(filter + length, filter + size);
+    auto query = hashes.begin();
+    uint64_t value = 0;
+    uint64_t quotient;
+    uint64_t remainder;
+
+    for (uint64_t index = 0; index < count; ++index)
+    {
+        if (!reader.read_unary(quotient) ||
+            !reader.read_bits(remainder, golomb_bits))
+            return false;
+
+        value += (quotient << golomb_bits) | remainder;
+        while (query != hashes.end() && *query < value)
+            ++query;
+
+        if (query == hashes.end())
+            return false;
+
+        if (*query == value)
+            return true;
+    }
+
+    return false;
+}
+
+// The calling thread is one of the workers.
+template <typename Filter>
+std::vector<size_t> filter_matcher::match_all(size_t count, size_t threads,
+    const Filter& filter) const
+{
+    if (threads == 0u)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    threads = std::max<size_t>(std::min(threads,
+        (count + run_size - 1u) / run_size), 1u);
+
+    std::atomic<size_t> next(0);
+    std::vector<std::vector<size_t>> found(threads);
+
+    const auto work = [&](std::vector<size_t>& out)
+    {
+        scratch space;
+        space.hashes.reserve(items_.size());
+        space.buffer.reserve(items_.size());
+
+        hash_digest hash;
+        const uint8_t* data;
+        size_t size;
+
+        for (auto first = next.fetch_add(run_size); first < count;
+            first = next.fetch_add(run_size))
+        {
+            const auto last = std::min(first + run_size, count);
+            for (auto index = first; index < last; ++index)
+                if (filter(index, hash, data, size) &&
+                    match(hash, data, size, space))
+                    out.push_back(index);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t worker = 1; worker < threads; ++worker)
+        workers.emplace_back(work, std::ref(found[worker]));
+
+    work(found.front());
+    for (auto& worker: workers)
+        worker.join();
+
+    std::vector<size_t> matched;
+    for (const auto& indexes: found)
+        matched.insert(matched.end(), indexes.begin(), indexes.end());
+
+    std::sort(matched.begin(), matched.end());
+    return matched;
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,337 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/filter_store.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+
+namespace libbitcoin {
+namespace client {
+
+static constexpr size_t header_offset = hash_size;
+static constexpr size_t offset_offset = 2u * hash_size;
+static constexpr size_t size_offset = offset_offset + sizeof(uint64_t);
+static constexpr size_t minimum_slots = 1024;
+
+// Block hashes are uniformly distributed, so any eight bytes are a key.
+static size_t slot_key(const uint8_t* hash)
+{
+    return static_cast<size_t>(from_little_endian_unsafe<uint64_t>(hash));
+}
+
+// Stores of each filter type may share a directory.
+static std::filesystem::path file_path(
+    const std::filesystem::path& directory, uint8_t filter_type,
+    const std::string& extension)
+{
+    return directory / ("filters_" + std::to_string(filter_type) + "." +
+        extension);
+}
+
+filter_store::filter_store(const std::filesystem::path& directory,
+    uint8_t filter_type)
+  : filter_type_(filter_type),
+    index_(file_path(directory, filter_type, "index")),
+    data_(file_path(directory, filter_type, "data")),
+    size_(0)
+{
+}
+
+// A failure to open closes the files without a flush, which would commit
+// the data of records that may not be valid.
+bool filter_store::open()
+{
+    const auto fail = [this]()
+    {
+        data_.close();
+        index_.close();
+        return false;
+    };
+
+    if (!index_.open())
+        return false;
+
+    if (!data_.open() ||
+        (index_.size() < header_size && !index_.resize(header_size)))
+        return fail();
+
+    // A count beyond the records of the file is corrupt.
+    const auto count = from_little_endian_unsafe<uint64_t>(index_.data());
+    if (count > (index_.size() - header_size) / record_size)
+        return fail();
+
+    // The data file is grown ahead of its data, and its pages may not have
+    // reached the disk before those of the index, so only the data flushed
+    // before the last commit is known to be written. Filters are appended,
+    // so those beyond it are at the top.
+    size_ = static_cast<size_t>(count);
+    const auto written = std::min<uint64_t>(committed(), data_.size());
+    auto size = size_;
+    while (size > 0u && offset(size - 1u) + filter_size(size - 1u) > written)
+        --size;
+
+    if (size != size_)
+        set_size(size);
+
+    rebuild();
+    return true;
+}
+
+bool filter_store::close()
+{
+    const auto flushed = !index_.is_open() || flush();
+    size_ = 0;
+    slots_.clear();
+    const auto data = data_.close();
+    return index_.close() && data && flushed;
+}
+
+uint8_t filter_store::filter_type() const
+{
+    return filter_type_;
+}
+
+size_t filter_store::size() const
+{
+    return size_;
+}
+
+bool filter_store::empty() const
+{
+    return size_ == 0;
+}
+
+bool filter_store::push(const hash_digest& block_hash,
+    const data_chunk& filter)
+{
+    if (!index_.is_open() || size_ >= empty_slot ||
+        filter.size() > max_uint32)
+        return false;
+
+    const auto end = data_end();
+    if (!data_.reserve(end + filter.size()) ||
+        !index_.reserve(header_size + (size_ + 1u) * record_size))
+        return false;
+
+    std::copy(filter.begin(), filter.end(), data_.data() + end);
+
+    const auto header = bitcoin_hash(build_chunk(
+    {
+        bitcoin_hash(filter),
+        top_header()
+    }));
+
+    const auto offset = to_little_endian(static_cast<uint64_t>(end));
+    const auto size = to_little_endian(static_cast<uint32_t>(filter.size()));
+    auto out = index_.data() + header_size + size_ * record_size;
+    std::copy(block_hash.begin(), block_hash.end(), out);
+    std::copy(header.begin(), header.end(), out + header_offset);
+    std::copy(offset.begin(), offset.end(), out + offset_offset);
+    std::copy(size.begin(), size.end(), out + size_offset);
+
+    set_size(size_ + 1u);
+
+    if (size_ * 2u > slots_.size())
+        rebuild();
+    else
+        index(size_ - 1u);
+
+    return true;
+}
+
+// The data of dropped filters is overwritten by those appended after them,
+// so the commit is lowered to the data kept, as that overwritten is not.
+bool filter_store::truncate(size_t height)
+{
+    if (!index_.is_open())
+        return false;
+
+    if (height >= size_)
+        return true;
+
+    set_size(height);
+    set_committed(std::min(committed(), data_end()));
+    rebuild();
+    return true;
+}
+
+bool filter_store::get(data_chunk& out, size_t height) const
+{
+    if (height >= size_)
+        return false;
+
+    const auto data = data_.data() + offset(height);
+    out.assign(data, data + filter_size(height));
+    return true;
+}
+
+const uint8_t* filter_store::filter_data(size_t height, size_t& size) const
+{
+    if (height >= size_)
+        return nullptr;
+
+    size = filter_size(height);
+    return data_.data() + offset(height);
+}
+
+bool filter_store::get(message::compact_filter& out, size_t height) const
+{
+    hash_digest hash;
+    data_chunk filter;
+    if (!block_hash(hash, height) || !get(filter, height))
+        return false;
+
+    out = message::compact_filter(filter_type_, hash, filter);
+    return true;
+}
+
+bool filter_store::get(size_t& out, const hash_digest& block_hash) const
+{
+    if (slots_.empty())
+        return false;
+
+    const auto mask = slots_.size() - 1u;
+    for (auto slot = slot_key(block_hash.data()) & mask;
+        slots_[slot] != empty_slot; slot = (slot + 1u) & mask)
+    {
+        const auto height = slots_[slot];
+        const auto stored = record(height);
+        if (std::equal(block_hash.begin(), block_hash.end(), stored))
+        {
+            out = height;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool filter_store::block_hash(hash_digest& out, size_t height) const
+{
+    if (height >= size_)
+        return false;
+
+    const auto hash = record(height);
+    std::copy(hash, hash + hash_size, out.begin());
+    return true;
+}
+
+bool filter_store::filter_header(hash_digest& out, size_t height) const
+{
+    if (height >= size_)
+        return false;
+
+    const auto header = record(height) + header_offset;
+    std::copy(header, header + hash_size, out.begin());
+    return true;
+}
+
+hash_digest filter_store::top_header() const
+{
+    auto header = null_hash;
+    if (!empty())
+        filter_header(header, size_ - 1u);
+
+    return header;
+}
+
+// The data is flushed before it is committed, so that no record within the
+// commit lacks its data.
+bool filter_store::flush()
+{
+    if (!index_.is_open() || !data_.flush())
+        return false;
+
+    set_committed(data_end());
+    return index_.flush();
+}
+
+const uint8_t* filter_store::record(size_t height) const
+{
+    return index_.data() + header_size + height * record_size;
+}
+
+uint64_t filter_store::offset(size_t height) const
+{
+    return from_little_endian_unsafe<uint64_t>(record(height) +
+        offset_offset);
+}
+
+uint32_t filter_store::filter_size(size_t height) const
+{
+    return from_little_endian_unsafe<uint32_t>(record(height) + size_offset);
+}
+
+uint64_t filter_store::data_end() const
+{
+    return empty() ? 0u : offset(size_ - 1u) + filter_size(size_ - 1u);
+}
+
+void filter_store::set_size(size_t size)
+{
+    size_ = size;
+    const auto count = to_little_endian(static_cast<uint64_t>(size));
+    std::copy(count.begin(), count.end(), index_.data());
+}
+
+uint64_t filter_store::committed() const
+{
+    return from_little_endian_unsafe<uint64_t>(index_.data() +
+        committed_offset);
+}
+
+void filter_store::set_committed(uint64_t size)
+{
+    const auto committed = to_little_endian(size);
+    std::copy(committed.begin(), committed.end(), index_.data() +
+        committed_offset);
+}
+
+void filter_store::index(size_t height)
+{
+    const auto mask = slots_.size() - 1u;
+    auto slot = slot_key(record(height)) & mask;
+
+    while (slots_[slot] != empty_slot)
+        slot = (slot + 1u) & mask;
+
+    slots_[slot] = static_cast<uint32_t>(height);
+}
+
+// The table is kept at most half full, and is rebuilt when filters are
+// dropped, as a reorganization is rare.
+void filter_store::rebuild()
+{
+    size_t slots = minimum_slots;
+    while (slots < size_ * 2u)
+        slots *= 2u;
+
+    slots_.assign(slots, empty_slot);
+    for (size_t height = 0; height < size_; ++height)
+        index(height);
+}
+
+} // namespace client
+} // namespace libbitcoin
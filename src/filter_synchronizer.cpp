@@ -0,0 +1,233 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/filter_synchronizer.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+using namespace bc::system::message;
+
+namespace libbitcoin {
+namespace client {
+
+filter_synchronizer::filter_synchronizer(obelisk_client& client,
+    filter_store& store, size_t batch, size_t window)
+  : client_(client),
+    store_(store),
+    batch_(std::max<size_t>(batch, 1)),
+    window_(std::max<size_t>(window, 1))
+{
+}
+
+void filter_synchronizer::synchronize(result_handler handler,
+    uint32_t timeout_milliseconds)
+{
+    if (current_)
+        complete(current_, error::operation_failed);
+
+    const auto sync = std::make_shared<pass>(pass
+    {
+        std::move(handler),
+        0,
+        0,
+        0,
+        0,
+        0,
+        timeout_milliseconds,
+        {},
+        {},
+        false
+    });
+
+    current_ = sync;
+
+    const auto on_height = [this, sync](const code& ec, size_t height)
+    {
+        if (sync->done)
+            return;
+
+        if (ec)
+        {
+            complete(sync, ec);
+            return;
+        }
+
+        sync->top = height;
+        request_batch(sync);
+    };
+
+    client_.blockchain_fetch_last_height(on_height, timeout_milliseconds);
+}
+
+bool filter_synchronizer::synchronizing() const
+{
+    return !!current_;
+}
+
+void filter_synchronizer::request_batch(const pass_ptr& sync)
+{
+    if (store_.size() > sync->top)
+    {
+        complete(sync, error::success);
+        return;
+    }
+
+    sync->start = store_.size();
+    sync->stop = std::min(sync->top, sync->start + batch_ - 1u);
+    sync->next_request = sync->start;
+    sync->filter_hashes.clear();
+    sync->buffer.clear();
+
+    const auto on_headers = [this, sync](const code& ec,
+        const compact_filter_headers& headers)
+    {
+        handle_batch(sync, ec, headers);
+    };
+
+    client_.blockchain_fetch_compact_filter_headers(on_headers,
+        store_.filter_type(), static_cast<uint32_t>(sync->start),
+        static_cast<uint32_t>(sync->stop), sync->timeout_milliseconds);
+}
+
+void filter_synchronizer::handle_batch(const pass_ptr& sync, const code& ec,
+    const compact_filter_headers& headers)
+{
+    if (sync->done)
+        return;
+
+    if (ec)
+    {
+        complete(sync, ec);
+        return;
+    }
+
+    if (headers.filter_hashes().size() != sync->stop - sync->start + 1u)
+    {
+        complete(sync, error::bad_stream);
+        return;
+    }
+
+    // The top is not an ancestor of the server's chain, so drop it and
+    // fetch the batch again from its height. The first filter has no
+    // ancestor, so a different previous header is invalid.
+    if (headers.previous_filter_header() != store_.top_header())
+    {
+        if (store_.empty())
+        {
+            complete(sync, error::bad_stream);
+            return;
+        }
+
+        store_.truncate(store_.size() - 1u);
+        request_batch(sync);
+        return;
+    }
+
+    sync->filter_hashes = headers.filter_hashes();
+    request(sync);
+}
+
+// Requests are issued only while fewer than window filters are unstored,
+// which bounds the filters buffered for reordering.
+void filter_synchronizer::request(const pass_ptr& sync)
+{
+    while (!sync->done && sync->next_request <= sync->stop &&
+        sync->in_flight < window_ &&
+        sync->next_request - store_.size() < window_)
+    {
+        const auto height = sync->next_request++;
+        const auto on_filter = [this, sync, height](const code& ec,
+            const compact_filter& filter)
+        {
+            handle(sync, height, ec, filter);
+        };
+
+        ++sync->in_flight;
+        client_.blockchain_fetch_compact_filter(on_filter,
+            store_.filter_type(), static_cast<uint32_t>(height),
+            sync->timeout_milliseconds);
+    }
+
+    if (sync->done || sync->in_flight != 0 || store_.size() <= sync->stop)
+        return;
+
+    if (!store_.flush())
+    {
+        complete(sync, error::operation_failed);
+        return;
+    }
+
+    request_batch(sync);
+}
+
+void filter_synchronizer::handle(const pass_ptr& sync, size_t height,
+    const code& ec, const compact_filter& filter)
+{
+    if (sync->done)
+        return;
+
+    --sync->in_flight;
+    if (ec)
+    {
+        complete(sync, ec);
+        return;
+    }
+
+    if (height >= store_.size())
+        sync->buffer.emplace(height, filter);
+
+    // A filter that does not match its hash in the batch is from another
+    // chain, as by a reorganization since the batch was fetched.
+    auto it = sync->buffer.begin();
+    while (it != sync->buffer.end() && it->first == store_.size())
+    {
+        const auto& next = it->second;
+        if (bitcoin_hash(next.filter()) !=
+            sync->filter_hashes[it->first - sync->start])
+        {
+            complete(sync, error::bad_stream);
+            return;
+        }
+
+        if (!store_.push(next.block_hash(), next.filter()))
+        {
+            complete(sync, error::operation_failed);
+            return;
+        }
+
+        it = sync->buffer.erase(it);
+    }
+
+    request(sync);
+}
+
+void filter_synchronizer::complete(const pass_ptr& sync, const code& ec)
+{
+    sync->done = true;
+    if (current_ == sync)
+        current_.reset();
+
+    sync->handler(ec);
+}
+
+} // namespace client
+} // namespace libbitcoin
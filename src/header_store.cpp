@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/header_store.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+
+static constexpr size_t header_size = 80;
+static constexpr size_t minimum_slots = 1024;
+
+// Block hashes are uniformly distributed, so any eight bytes are a key.
+static size_t slot_key(const uint8_t* hash)
+{
+    return static_cast<size_t>(from_little_endian_unsafe<uint64_t>(hash));
+}
+
+header_store::header_store(const std::filesystem::path& path)
+  : file_(path), size_(0)
+{
+}
+
+bool header_store::open()
+{
+    if (!file_.open())
+        return false;
+
+    if (file_.size() < count_size && !file_.resize(count_size))
+    {
+        file_.close();
+        return false;
+    }
+
+    // A count beyond the records of the file is corrupt.
+    const auto count = from_little_endian_unsafe<uint64_t>(file_.data());
+    if (count > (file_.size() - count_size) / record_size)
+    {
+        file_.close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(count);
+    rebuild();
+    return true;
+}
+
+bool header_store::close()
+{
+    size_ = 0;
+    slots_.clear();
+    return file_.close();
+}
+
+size_t header_store::size() const
+{
+    return size_;
+}
+
+bool header_store::empty() const
+{
+    return size_ == 0;
+}
+
+bool header_store::push(const header& header)
+{
+    if (!file_.is_open() || size_ >= empty_slot ||
+        !file_.reserve(count_size + (size_ + 1u) * record_size))
+        return false;
+
+    const auto data = header.to_data();
+    const auto hash = header.hash();
+    auto out = file_.data() + count_size + size_ * record_size;
+    std::copy(data.begin(), data.end(), out);
+    std::copy(hash.begin(), hash.end(), out + header_size);
+
+    set_size(size_ + 1u);
+
+    if (size_ * 2u > slots_.size())
+        rebuild();
+    else
+        index(size_ - 1u);
+
+    return true;
+}
+
+bool header_store::truncate(size_t height)
+{
+    if (!file_.is_open())
+        return false;
+
+    if (height >= size_)
+        return true;
+
+    set_size(height);
+    rebuild();
+    return true;
+}
+
+bool header_store::get(header& out, size_t height) const
+{
+    if (height >= size_)
+        return false;
+
+    const auto data = record(height);
+    return out.from_data(data_chunk{ data, data + header_size });
+}
+
+bool header_store::get(hash_digest& out, size_t height) const
+{
+    if (height >= size_)
+        return false;
+
+    const auto hash = record(height) + header_size;
+    std::copy(hash, hash + hash_size, out.begin());
+    return true;
+}
+
+bool header_store::get(size_t& out, const hash_digest& hash) const
+{
+    if (slots_.empty())
+        return false;
+
+    const auto mask = slots_.size() - 1u;
+    for (auto slot = slot_key(hash.data()) & mask;
+        slots_[slot] != empty_slot; slot = (slot + 1u) & mask)
+    {
+        const auto height = slots_[slot];
+        const auto stored = record(height) + header_size;
+        if (std::equal(hash.begin(), hash.end(), stored))
+        {
+            out = height;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool header_store::flush()
+{
+    return file_.flush();
+}
+
+const uint8_t* header_store::record(size_t height) const
+{
+    return file_.data() + count_size + height * record_size;
+}
+
+void header_store::set_size(size_t size)
+{
+    size_ = size;
+    const auto count = to_little_endian(static_cast<uint64_t>(size));
+    std::copy(count.begin(), count.end(), file_.data());
+}
+
+void header_store::index(size_t height)
+{
+    const auto mask = slots_.size() - 1u;
+    auto slot = slot_key(record(height) + header_size) & mask;
+
+    while (slots_[slot] != empty_slot)
+        slot = (slot + 1u) & mask;
+
+    slots_[slot] = static_cast<uint32_t>(height);
+}
+
+// The table is kept at most half full, and is rebuilt when headers are
+// dropped, as a reorganization is rare.
+void header_store::rebuild()
+{
+    size_t slots = minimum_slots;
+    while (slots < size_ * 2u)
+        slots *= 2u;
+
+    slots_.assign(slots, empty_slot);
+    for (size_t height = 0; height < size_; ++height)
+        index(height);
+}
+
+} // namespace client
+} // namespace libbitcoin
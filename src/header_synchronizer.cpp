@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/header_synchronizer.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+
+header_synchronizer::header_synchronizer(obelisk_client& client,
+    header_store& store, size_t window)
+  : client_(client), store_(store), window_(std::max<size_t>(window, 1))
+{
+}
+
+void header_synchronizer::synchronize(result_handler handler,
+    uint32_t timeout_milliseconds)
+{
+    if (current_)
+        complete(current_, error::operation_failed);
+
+    const auto sync = std::make_shared<pass>(pass
+    {
+        std::move(handler),
+        0,
+        0,
+        0,
+        timeout_milliseconds,
+        {},
+        false
+    });
+
+    current_ = sync;
+
+    const auto on_height = [this, sync](const code& ec, size_t height)
+    {
+        if (sync->done)
+            return;
+
+        if (ec)
+        {
+            complete(sync, ec);
+            return;
+        }
+
+        sync->top = height;
+        sync->next_request = store_.size();
+        request(sync);
+    };
+
+    client_.blockchain_fetch_last_height(on_height, timeout_milliseconds);
+}
+
+bool header_synchronizer::update(const header& header,
+    result_handler handler, uint32_t timeout_milliseconds)
+{
+    if (!current_ && !store_.empty() && links(header))
+    {
+        const auto pushed = store_.push(header);
+        handler(pushed ? error::success : error::operation_failed);
+        return pushed;
+    }
+
+    synchronize(std::move(handler), timeout_milliseconds);
+    return false;
+}
+
+bool header_synchronizer::synchronizing() const
+{
+    return !!current_;
+}
+
+// Requests are issued only while fewer than window headers are unstored,
+// which bounds the headers buffered for reordering.
+void header_synchronizer::request(const pass_ptr& sync)
+{
+    while (!sync->done && sync->next_request <= sync->top &&
+        sync->in_flight < window_ &&
+        sync->next_request - store_.size() < window_)
+    {
+        const auto height = sync->next_request++;
+        const auto on_header = [this, sync, height](const code& ec,
+            const chain::header& header)
+        {
+            handle(sync, height, ec, header);
+        };
+
+        ++sync->in_flight;
+        client_.blockchain_fetch_block_header(on_header,
+            static_cast<uint32_t>(height), sync->timeout_milliseconds);
+    }
+
+    if (!sync->done && sync->in_flight == 0 && store_.size() > sync->top)
+        complete(sync, error::success);
+}
+
+void header_synchronizer::handle(const pass_ptr& sync, size_t height,
+    const code& ec, const chain::header& header)
+{
+    if (sync->done)
+        return;
+
+    --sync->in_flight;
+    if (ec)
+    {
+        complete(sync, ec);
+        return;
+    }
+
+    if (height >= store_.size())
+        sync->buffer.emplace(height, header);
+
+    auto it = sync->buffer.begin();
+    while (it != sync->buffer.end() && it->first == store_.size())
+    {
+        // The top is not an ancestor of the server's chain, so drop it and
+        // fetch its height again. Buffered headers are from the server's
+        // chain, but are dropped so that the buffer stays within the window.
+        if (!links(it->second))
+        {
+            store_.truncate(store_.size() - 1u);
+            sync->buffer.clear();
+            sync->next_request = store_.size();
+            break;
+        }
+
+        if (!store_.push(it->second))
+        {
+            complete(sync, error::operation_failed);
+            return;
+        }
+
+        it = sync->buffer.erase(it);
+    }
+
+    request(sync);
+}
+
+void header_synchronizer::complete(const pass_ptr& sync, const code& ec)
+{
+    sync->done = true;
+    if (current_ == sync)
+        current_.reset();
+
+    sync->handler(ec);
+}
+
+bool header_synchronizer::links(const chain::header& header) const
+{
+    if (store_.empty())
+        return true;
+
+    hash_digest top;
+    return store_.get(top, store_.size() - 1u) &&
+        header.previous_block_hash() == top;
+}
+
+} // namespace client
+} // namespace libbitcoin
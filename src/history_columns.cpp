@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/history_columns.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+
+size_t history_columns::size() const
+{
+    return values.size();
+}
+
+bool history_columns::empty() const
+{
+    return values.empty();
+}
+
+void history_columns::reserve(size_t rows)
+{
+    output_hashes.reserve(rows);
+    output_indexes.reserve(rows);
+    output_heights.reserve(rows);
+    values.reserve(rows);
+    spend_hashes.reserve(rows);
+    spend_indexes.reserve(rows);
+    spend_heights.reserve(rows);
+}
+
+void history_columns::emplace_back(const output_point& output,
+    uint64_t output_height, uint64_t value, const input_point& spend,
+    uint64_t spend_height)
+{
+    output_hashes.push_back(output.hash());
+    output_indexes.push_back(output.index());
+    output_heights.push_back(output_height);
+    values.push_back(value);
+    spend_hashes.push_back(spend.hash());
+    spend_indexes.push_back(spend.index());
+    spend_heights.push_back(spend_height);
+}
+
+history history_columns::row(size_t index) const
+{
+    return
+    {
+        { output_hashes[index], output_indexes[index] },
+        output_heights[index],
+        values[index],
+        { spend_hashes[index], spend_indexes[index] },
+        spend_heights[index]
+    };
+}
+
+// A spend-only row has a spend height, so only outputs are unspent rows.
+// The loops are branch free so that they may be vectorized.
+uint64_t history_columns::balance() const
+{
+    const auto rows = size();
+    const auto value = values.data();
+    const auto height = spend_heights.data();
+
+    uint64_t total = 0;
+    for (size_t row = 0; row < rows; ++row)
+        total += (height[row] == max_uint64) ? value[row] : 0;
+
+    return total;
+}
+
+size_t history_columns::unspent() const
+{
+    const auto rows = size();
+    const auto height = spend_heights.data();
+
+    size_t count = 0;
+    for (size_t row = 0; row < rows; ++row)
+        count += (height[row] == max_uint64) ? 1 : 0;
+
+    return count;
+}
+
+void set_spend(history_columns& rows, size_t row, const input_point& spend,
+    uint64_t spend_height)
+{
+    rows.spend_hashes[row] = spend.hash();
+    rows.spend_indexes[row] = spend.index();
+    rows.spend_heights[row] = spend_height;
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/history_synchronizer.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <bitcoin/client/history_builder.hpp>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+using namespace bc::system::wallet;
+
+namespace libbitcoin {
+namespace client {
+
+history_synchronizer::history_synchronizer(obelisk_client& client,
+    uint32_t overlap)
+  : client_(client), overlap_(overlap)
+{
+}
+
+void history_synchronizer::synchronize(history_handler handler,
+    const hash_digest& key, uint32_t timeout_milliseconds)
+{
+    const auto from = from_height(key);
+
+    auto on_payments = [this, handler, key, from](const code& ec,
+        const payment_record::list& payments)
+    {
+        if (ec)
+        {
+            handler(ec, {});
+            return;
+        }
+
+        history::list rows;
+
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock();
+        auto& cached = cache_[key];
+        merge(cached, from, payments);
+        rows = cached.rows;
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        handler(ec, rows);
+    };
+
+    client_.blockchain_fetch_history4_payments(std::move(on_payments), key,
+        from, timeout_milliseconds);
+}
+
+uint32_t history_synchronizer::from_height(const hash_digest& key) const
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = cache_.find(key);
+    if (it == cache_.end())
+        return 0;
+
+    const auto height = it->second.height;
+    return height > overlap_ ? height - overlap_ : 0;
+}
+
+history::list history_synchronizer::cached(const hash_digest& key) const
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = cache_.find(key);
+    return it == cache_.end() ? history::list{} : it->second.rows;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void history_synchronizer::forget(const hash_digest& key)
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.erase(key);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t history_synchronizer::size() const
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Payments below from are ignored, as they are cached, though a server
+// should not return them. The height is that of the merged rows, as those
+// fetched are authoritative, so it is lowered by a reorganization that
+// removes the rows above from.
+void history_synchronizer::merge(entry& cached, uint32_t from,
+    const payment_record::list& payments)
+{
+    history_builder builder(cached.rows.size() + payments.size());
+    history::list kept_spends;
+    uint64_t height = 0;
+
+    for (const auto& row: cached.rows)
+    {
+        // A spend-only row has no output to correlate with, so is kept as is.
+        if (row.output.is_null())
+        {
+            if (row.spend_height < from)
+            {
+                kept_spends.push_back(row);
+                height = std::max(height, row.spend_height);
+            }
+
+            continue;
+        }
+
+        if (row.output_height >= from)
+            continue;
+
+        builder.add_output(row.output, row.output_height, row.value);
+        height = std::max(height, row.output_height);
+
+        if (!row.spend.is_null() && row.spend_height < from)
+        {
+            builder.add_spend(row.spend, row.spend_height,
+                row.output.checksum());
+            height = std::max(height, row.spend_height);
+        }
+    }
+
+    for (const auto& payment: payments)
+    {
+        if (payment.height() < from)
+            continue;
+
+        height = std::max(height, static_cast<uint64_t>(payment.height()));
+
+        if (payment.is_output())
+            builder.add_output({ payment.hash(), payment.index() },
+                payment.height(), payment.data());
+        else
+            builder.add_spend({ payment.hash(), payment.index() },
+                payment.height(), payment.data());
+    }
+
+    cached.rows = builder.finish();
+    cached.rows.insert(cached.rows.end(), kept_spends.begin(),
+        kept_spends.end());
+    cached.height = static_cast<uint32_t>(height);
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,278 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/mapped_file.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace client {
+
+#ifdef _WIN32
+
+mapped_file::mapped_file(const std::filesystem::path& path)
+  : path_(path), size_(0), data_(nullptr), file_(INVALID_HANDLE_VALUE),
+    mapping_(nullptr)
+{
+}
+
+bool mapped_file::open()
+{
+    if (is_open())
+        return false;
+
+    file_ = CreateFileW(path_.c_str(), GENERIC_READ | GENERIC_WRITE,
+        FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size))
+    {
+        close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(size.QuadPart);
+    if (!map())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool mapped_file::close()
+{
+    if (!is_open())
+        return true;
+
+    const auto flushed = flush();
+    const auto unmapped = unmap();
+    const auto closed = CloseHandle(file_) != FALSE;
+    file_ = INVALID_HANDLE_VALUE;
+    size_ = 0;
+    return flushed && unmapped && closed;
+}
+
+bool mapped_file::is_open() const
+{
+    return file_ != INVALID_HANDLE_VALUE;
+}
+
+bool mapped_file::resize(size_t size)
+{
+    if (!is_open() || !unmap())
+        return false;
+
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(file_, position, nullptr, FILE_BEGIN) ||
+        !SetEndOfFile(file_))
+    {
+        map();
+        return false;
+    }
+
+    size_ = size;
+    return map();
+}
+
+bool mapped_file::flush()
+{
+    return data_ == nullptr || FlushViewOfFile(data_, 0) != FALSE;
+}
+
+bool mapped_file::map()
+{
+    if (size_ == 0)
+        return true;
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READWRITE, 0, 0,
+        nullptr);
+
+    if (mapping_ == nullptr)
+        return false;
+
+    data_ = static_cast<uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_WRITE, 0,
+        0, size_));
+
+    return data_ != nullptr;
+}
+
+bool mapped_file::unmap()
+{
+    auto success = true;
+
+    if (data_ != nullptr)
+        success &= UnmapViewOfFile(data_) != FALSE;
+
+    if (mapping_ != nullptr)
+        success &= CloseHandle(mapping_) != FALSE;
+
+    data_ = nullptr;
+    mapping_ = nullptr;
+    return success;
+}
+
+#else
+
+mapped_file::mapped_file(const std::filesystem::path& path)
+  : path_(path), size_(0), data_(nullptr), file_(-1)
+{
+}
+
+bool mapped_file::open()
+{
+    if (is_open())
+        return false;
+
+    file_ = ::open(path_.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (file_ == -1)
+        return false;
+
+    struct stat status;
+    if (::fstat(file_, &status) == -1)
+    {
+        close();
+        return false;
+    }
+
+    size_ = static_cast<size_t>(status.st_size);
+    if (!map())
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool mapped_file::close()
+{
+    if (!is_open())
+        return true;
+
+    const auto flushed = flush();
+    const auto unmapped = unmap();
+    const auto closed = ::close(file_) != -1;
+    file_ = -1;
+    size_ = 0;
+    return flushed && unmapped && closed;
+}
+
+bool mapped_file::is_open() const
+{
+    return file_ != -1;
+}
+
+bool mapped_file::resize(size_t size)
+{
+    if (!is_open() || !unmap())
+        return false;
+
+    if (::ftruncate(file_, static_cast<off_t>(size)) == -1)
+    {
+        map();
+        return false;
+    }
+
+    size_ = size;
+    return map();
+}
+
+bool mapped_file::flush()
+{
+    return data_ == nullptr || ::msync(data_, size_, MS_SYNC) != -1;
+}
+
+bool mapped_file::map()
+{
+    if (size_ == 0)
+        return true;
+
+    const auto data = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE,
+        MAP_SHARED, file_, 0);
+
+    if (data == MAP_FAILED)
+        return false;
+
+    data_ = static_cast<uint8_t*>(data);
+    return true;
+}
+
+bool mapped_file::unmap()
+{
+    if (data_ == nullptr)
+        return true;
+
+    const auto success = ::munmap(data_, size_) != -1;
+    data_ = nullptr;
+    return success;
+}
+
+#endif
+
+mapped_file::~mapped_file()
+{
+    close();
+}
+
+size_t mapped_file::size() const
+{
+    return size_;
+}
+
+uint8_t* mapped_file::data()
+{
+    return data_;
+}
+
+const uint8_t* mapped_file::data() const
+{
+    return data_;
+}
+
+bool mapped_file::reserve(size_t size)
+{
+    if (size <= size_)
+        return true;
+
+    return resize(std::max(size, size_ + size_ / 2u));
+}
+
+} // namespace client
+} // namespace libbitcoin
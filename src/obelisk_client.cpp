@@ -19,8 +19,19 @@
 #include <bitcoin/client/obelisk_client.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
 
+#include <bitcoin/client/history_builder.hpp>
 #include <bitcoin/protocol/zmq/message.hpp>
 
 using namespace bc::protocol;
@@ -43,7 +54,206 @@ static const config::endpoint public_subscribe_worker(
 static const config::endpoint secure_subscribe_worker(
     "inproc://secure_subscribe_client");
 
-obelisk_client::obelisk_client(int32_t retries)
+// A block missed by the block feed is fetched again if not fetched in this
+// time.
+static constexpr uint32_t backfill_timeout_milliseconds = 30000;
+
+// A payment row is [kind:1][hash:32][index:4][height:4][value|checksum:8].
+static constexpr size_t history_row_size = 1 + hash_size + 4 + 4 + 8;
+
+// Decode the history payload into rows, empty if the payload is invalid.
+template <typename Rows>
+static code decode_history(const data_chunk& payload, Rows& out)
+{
+    data_source istream(payload);
+    istream_reader source(istream);
+    const auto ec = source.read_error_code();
+
+    // Rows are of fixed size, so the result is sized from the payload.
+    const auto rows = (payload.size() - std::min(payload.size(),
+        sizeof(uint32_t))) / history_row_size;
+
+    payment_record payment;
+    basic_history_builder<Rows> builder(rows);
+    while (!source.is_exhausted())
+    {
+        if (!payment.from_data(source, true))
+            return ec;
+
+        if (payment.is_output())
+            builder.add_output({ payment.hash(), payment.index() },
+                payment.height(), payment.data());
+        else
+            builder.add_spend({ payment.hash(), payment.index() },
+                payment.height(), payment.data());
+    }
+
+    out = builder.finish();
+    return ec;
+}
+
+// Decode the history payload as received, empty if the payload is invalid.
+static code decode_payments(const data_chunk& payload,
+    payment_record::list& out)
+{
+    data_source istream(payload);
+    istream_reader source(istream);
+    const auto ec = source.read_error_code();
+
+    payment_record::list payments;
+    payments.reserve((payload.size() - std::min(payload.size(),
+        sizeof(uint32_t))) / history_row_size);
+
+    payment_record payment;
+    while (!source.is_exhausted())
+    {
+        if (!payment.from_data(source, true))
+            return ec;
+
+        payments.push_back(payment);
+    }
+
+    out = std::move(payments);
+    return ec;
+}
+
+// A block view takes the block following the code, unparsed, in the payload.
+static void answer_view(const obelisk_client::block_view_handler& handler,
+    const block_view::buffer_ptr& payload)
+{
+    // A truncated code would be read as success.
+    if (payload->size() < sizeof(uint32_t))
+    {
+        handler(error::bad_stream, {});
+        return;
+    }
+
+    data_source istream(*payload);
+    istream_reader source(istream);
+    const auto ec = source.read_error_code();
+    if (ec)
+    {
+        handler(ec, {});
+        return;
+    }
+
+    const block_view view(payload, sizeof(uint32_t));
+    handler(view.is_valid() ? ec : error::bad_stream, view);
+}
+
+// Deliver the history payload to the handler, in chunks of correlated rows.
+static void deliver_history(const data_chunk& payload,
+    const obelisk_client::history_chunks& chunks)
+{
+    const auto& handler = chunks.handler;
+    const auto chunk_rows = std::max<size_t>(chunks.rows, 1);
+    const auto rows = (payload.size() - std::min(payload.size(),
+        sizeof(uint32_t))) / history_row_size;
+
+    data_source spends_stream(payload);
+    istream_reader spends(spends_stream);
+    const auto ec = spends.read_error_code();
+    if (ec)
+    {
+        handler(ec, {}, true);
+        return;
+    }
+
+    // Only spends are held, so the index is sized by the spend rows, read
+    // from the kind of each row (an output is zero).
+    size_t spend_rows = 0;
+    for (auto row = sizeof(uint32_t); row + history_row_size <= payload.size();
+        row += history_row_size)
+        if (payload[row] != 0)
+            ++spend_rows;
+
+    // Index all spends, so that each output is complete when read.
+    payment_record payment;
+    history_builder builder(spend_rows, history_builder::spends_only);
+    while (!spends.is_exhausted())
+    {
+        if (!payment.from_data(spends, true))
+        {
+            handler(error::bad_stream, {}, true);
+            return;
+        }
+
+        if (!payment.is_output())
+            builder.add_spend({ payment.hash(), payment.index() },
+                payment.height(), payment.data());
+    }
+
+    history::list chunk;
+    chunk.reserve(std::min(chunk_rows, rows));
+    const auto deliver = [&](history&& row)
+    {
+        chunk.push_back(std::move(row));
+        if (chunk.size() == chunk_rows)
+        {
+            handler(ec, chunk, false);
+            chunk.clear();
+        }
+    };
+
+    data_source outputs_stream(payload);
+    istream_reader outputs(outputs_stream);
+    outputs.read_error_code();
+    while (!outputs.is_exhausted())
+    {
+        payment.from_data(outputs, true);
+        if (payment.is_output())
+            deliver(builder.complete_output({ payment.hash(),
+                payment.index() }, payment.height(), payment.data()));
+    }
+
+    for (auto& spend: builder.finish())
+        deliver(std::move(spend));
+
+    handler(ec, chunk, true);
+}
+
+// The key of a request that may be cached or coalesced, as sent after its id.
+static data_chunk request_key(command type, const data_chunk& payload)
+{
+    return build_chunk({ to_array(static_cast<uint8_t>(type)), payload });
+}
+
+// Handlers that are functions, which are those that may be coalesced.
+template <typename Handler>
+struct is_function_handler
+  : std::false_type
+{
+};
+
+template <typename Signature>
+struct is_function_handler<std::function<Signature>>
+  : std::true_type
+{
+};
+
+// Invokes each of the handlers with the one response.
+template <typename Handler>
+static Handler join_handlers(std::vector<Handler>&& handlers)
+{
+    return [handlers = std::move(handlers)](const auto&... response)
+    {
+        for (const auto& handler: handlers)
+            handler(response...);
+    };
+}
+
+// The poll timeout to the deadline, rounded up so that the poll does not
+// return before the deadline has passed.
+static int32_t remaining(const steady_clock::time_point& deadline)
+{
+    const auto milliseconds = ceil<std::chrono::milliseconds>(
+        deadline - steady_clock::now()).count();
+
+    return static_cast<int32_t>(std::min<int64_t>(std::max<int64_t>(
+        milliseconds, 0), max_int32));
+}
+
+obelisk_client::obelisk_client(int32_t retries, bool direct_send)
   : socket_(context_, zmq::socket::role::dealer),
     subscribe_socket_(context_, zmq::socket::role::dealer),
     block_socket_(context_, zmq::socket::role::subscriber),
@@ -53,16 +263,60 @@ obelisk_client::obelisk_client(int32_t retries)
     subscribe_dealer_(context_, zmq::socket::role::dealer),
     subscribe_router_(context_, zmq::socket::role::router),
     retries_(retries),
-    last_request_index_(0),
     secure_(false),
+    direct_send_(direct_send),
     worker_(public_worker),
-    subscribe_worker_(public_subscribe_worker)
+    subscribe_worker_(public_subscribe_worker),
+    last_request_index_(0),
+    connections_{ &socket_ },
+    outstanding_(1, 0),
+    limits_(1),
+    next_connection_(0),
+    adaptive_(false),
+    window_(0),
+    in_flight_(0),
+    backlogged_(false),
+    running_(false),
+    stopping_(false),
+    doorbell_armed_(false),
+    doorbell_bound_(false),
+    doorbell_(context_, zmq::socket::role::pair),
+    doorbell_sender_(context_, zmq::socket::role::pair),
+    monitor_bell_armed_(false),
+    monitor_bell_bound_(false),
+    monitor_bell_(context_, zmq::socket::role::pair),
+    monitor_bell_sender_(context_, zmq::socket::role::pair),
+    sequence_blocks_(false),
+    block_sequencer_(
+        std::bind(&obelisk_client::fetch_missing_block, this,
+            std::placeholders::_1),
+        std::bind(&obelisk_client::deliver_block, this,
+            std::placeholders::_2), block_sequencer::default_window,
+        std::bind(&obelisk_client::fail_missing_block, this,
+            std::placeholders::_1)),
+    transaction_sequence_(0),
+    transaction_sequenced_(false),
+    cache_depth_(default_cache_depth),
+    top_height_(0)
 {
     attach_handlers();
 }
 
 obelisk_client::~obelisk_client()
 {
+    stop();
+
+    doorbell_.stop();
+    doorbell_sender_.stop();
+
+    // Join the block workers before the socket they notify is stopped.
+    block_decoder_.reset();
+    monitor_bell_.stop();
+    monitor_bell_sender_.stop();
+
+    for (auto& connection: pool_)
+        connection->stop();
+
     dealer_.stop();
     router_.stop();
     subscribe_dealer_.stop();
@@ -76,8 +330,191 @@ obelisk_client::~obelisk_client()
 bool obelisk_client::connect(const connection_settings& settings)
 {
     retries_ = settings.retries;
-    return connect(settings.server, settings.socks, settings.server_public_key,
-        settings.client_private_key);
+    direct_send_ = settings.direct_send;
+    window_ = settings.window;
+    adaptive_ = settings.adaptive;
+    if (!connect(settings.server, settings.socks, settings.server_public_key,
+        settings.client_private_key))
+        return false;
+
+    for (const auto& address: settings.pool)
+        if (!add_connection(address, settings.socks,
+            settings.server_public_key, settings.client_private_key))
+            return false;
+
+    return true;
+}
+
+bool obelisk_client::connect(const std::vector<endpoint>& addresses)
+{
+    if (addresses.empty() || !connect(addresses.front()))
+        return false;
+
+    for (auto address = std::next(addresses.begin());
+        address != addresses.end(); ++address)
+        if (!add_connection(*address, {}, {}, {}))
+            return false;
+
+    return true;
+}
+
+bool obelisk_client::add_connection(const endpoint& address,
+    const authority& socks_proxy, const zmq::sodium& server_public_key,
+    const zmq::sodium& client_private_key)
+{
+    auto socket = std::make_unique<zmq::socket>(context_,
+        zmq::socket::role::dealer);
+
+    if (socks_proxy && !socket->set_socks_proxy(socks_proxy))
+        return false;
+
+    if (server_public_key && (!socket->set_curve_client(server_public_key) ||
+        !socket->set_certificate({ client_private_key })))
+        return false;
+
+    if (socket->connect(address.to_string()) != error::success)
+        return false;
+
+    connections_.push_back(socket.get());
+    pool_.push_back(std::move(socket));
+    outstanding_.push_back(0);
+    limits_.emplace_back();
+    return true;
+}
+
+size_t obelisk_client::connections() const
+{
+    return connections_.size();
+}
+
+size_t obelisk_client::outstanding(size_t connection) const
+{
+    return connection < outstanding_.size() ? outstanding_[connection] : 0;
+}
+
+void obelisk_client::set_window(size_t window, backpressure_handler handler)
+{
+    window_ = window;
+    on_backpressure_ = std::move(handler);
+}
+
+bool obelisk_client::backlogged() const
+{
+    return backlogged_;
+}
+
+void obelisk_client::set_adaptive(bool adaptive)
+{
+    adaptive_ = adaptive;
+}
+
+size_t obelisk_client::limit(size_t connection) const
+{
+    return connection < limits_.size() ? limits_[connection].limit() : 0;
+}
+
+bool obelisk_client::set_block_decoders(size_t threads)
+{
+    block_decoder_.reset();
+    if (threads == 0)
+        return true;
+
+    if (!bind_monitor_bell())
+        return false;
+
+    block_decoder_ = std::make_unique<block_decoder>(threads,
+        std::bind(&obelisk_client::ring_monitor, this));
+
+    return true;
+}
+
+bool obelisk_client::track_blocks(size_t last_height, size_t top_height,
+    feed_gap_handler on_gap)
+{
+    if (!bind_monitor_bell())
+        return false;
+
+    sequence_blocks_ = true;
+    on_block_gap_ = on_gap;
+    block_sequencer_.track(last_height);
+    block_sequencer_.backfill(top_height);
+    return true;
+}
+
+size_t obelisk_client::block_height() const
+{
+    return block_sequencer_.last_height();
+}
+
+void obelisk_client::set_cache(size_t budget_bytes, size_t depth)
+{
+    cache_depth_ = depth;
+    cache_ = budget_bytes == 0 ? nullptr :
+        std::make_unique<response_cache>(budget_bytes);
+}
+
+response_cache* obelisk_client::cache() const
+{
+    return cache_.get();
+}
+
+response_cache::value obelisk_client::find_cached(const data_chunk& key,
+    bool cacheable)
+{
+    return cache_ && cacheable ? cache_->find(key) : nullptr;
+}
+
+bool obelisk_client::buried(size_t height) const
+{
+    const size_t top = top_height_;
+    return top >= cache_depth_ && height <= top - cache_depth_;
+}
+
+// Subscription commands are skipped, as their ids are not in the request
+// table, and the command is matched as a subscription may reuse a request id.
+void obelisk_client::cache_response(command type, uint32_t id,
+    const data_chunk& payload)
+{
+    if (type == command::subscribe_key || type == command::notification_key ||
+        type == command::unsubscribe_key)
+        return;
+
+    const auto pending = request_handlers_.find(id);
+    if (pending == nullptr || !pending->cacheable ||
+        pending->key.front() != static_cast<uint8_t>(type))
+        return;
+
+    if (payload.size() < sizeof(uint32_t) ||
+        from_little_endian_unsafe<uint32_t>(payload.data()) != 0)
+        return;
+
+    cache_->store(data_chunk(pending->key), payload);
+}
+
+void obelisk_client::observe_height(size_t height)
+{
+    auto top = top_height_.load();
+    while (height > top && !top_height_.compare_exchange_weak(top, height));
+}
+
+// Ties are broken in rotation, so that an idle pool is used evenly.
+size_t obelisk_client::select_connection()
+{
+    const auto count = connections_.size();
+    auto selected = unsent;
+
+    for (size_t offset = 0; offset < count; ++offset)
+    {
+        const auto connection = (next_connection_ + offset) % count;
+        if (admits(connection) && (selected == unsent ||
+            outstanding_[connection] < outstanding_[selected]))
+            selected = connection;
+    }
+
+    if (selected != unsent)
+        next_connection_ = selected + 1;
+
+    return selected;
 }
 
 bool obelisk_client::connect(const endpoint& address,
@@ -113,11 +550,15 @@ bool obelisk_client::connect(const endpoint& address)
 {
     const auto host_address = address.to_string();
 
-    auto connect_socket = [&host_address](zmq::socket& socket,
+    auto connect_socket = [this, &host_address](zmq::socket& socket,
         zmq::socket& dealer, zmq::socket& router, config::endpoint& worker)
     {
         if (socket.connect(host_address) == error::success)
         {
+            // Requests are sent on the socket, so no forwarding is required.
+            if (direct_send_)
+                return true;
+
             // Bind internal router(s) to inproc worker
             auto ec = router.bind(worker);
             if (ec)
@@ -169,7 +610,30 @@ void obelisk_client::forward_message(zmq::socket& source, zmq::socket& sink)
     sink.send(packet);
 }
 
-void obelisk_client::process_response(zmq::socket& socket)
+void obelisk_client::forward_request()
+{
+    zmq::message packet;
+    router_.receive(packet);
+
+    // Strip the router identity and the connection before forwarding.
+    uint32_t connection = 0;
+    packet.dequeue();
+    packet.dequeue(connection);
+
+    if (connection < connections_.size())
+        connections_[connection]->send(packet);
+}
+
+void obelisk_client::process_responses(const zmq::identifiers& identifiers)
+{
+    for (const auto connection: connections_)
+        if (identifiers.contains(connection->id()))
+            process_response(*connection, true);
+}
+
+// Only the request connections are read by the loop that owns the request
+// table, which the cache lookup reads, so only their responses are cached.
+void obelisk_client::process_response(zmq::socket& socket, bool cache)
 {
     // Process server responses.
     zmq::message message;
@@ -180,40 +644,88 @@ void obelisk_client::process_response(zmq::socket& socket)
         message.dequeue();
 
     uint32_t id = 0;
-    std::string command;
     data_chunk payload;
 
-    message.dequeue(command);
+    const auto type = to_command(message.dequeue_data());
     message.dequeue(id);
     message.dequeue(payload);
 
-    const auto handler = command_handlers_.find(command);
-    if (handler != command_handlers_.end())
-        handler->second(command, id, payload);
+    // Shared, so that a block view is over the payload rather than a copy.
+    const auto shared = std::make_shared<const data_chunk>(std::move(payload));
+
+    if (cache && cache_ && type != command::unknown)
+        cache_response(type, id, *shared);
+
+    handle_response(type, id, shared);
+}
+
+void obelisk_client::handle_response(command type, uint32_t id,
+    const response_cache::value& payload)
+{
+    block_view_handler view_handler;
+    if (type == command::blockchain_fetch_block &&
+        take_handler(id, view_handler))
+    {
+        answer_view(view_handler, payload);
+        return;
+    }
+
+    handle_response(type, id, *payload);
+}
+
+void obelisk_client::handle_response(command type, uint32_t id,
+    const data_chunk& payload)
+{
+    if (type == command::unknown)
+        return;
+
+    const auto& handler = command_handlers_[static_cast<size_t>(type)];
+    if (handler)
+        handler(type, id, payload);
 }
 
 // Used by query commands and fires handlers as needed.
 void obelisk_client::wait(uint32_t timeout_milliseconds)
 {
+    // The reactor thread owns the request sockets while running.
+    if (running_)
+        return;
+
     zmq::poller poller;
-    poller.add(socket_);
-    poller.add(router_);
+    for (const auto connection: connections_)
+        poller.add(*connection);
+
+    if (!direct_send_)
+        poller.add(router_);
 
-    static constexpr auto poll_timeout_milliseconds = 10;
-    auto deadline = steady_clock::now() + milliseconds(timeout_milliseconds);
+    const auto deadline = steady_clock::now() +
+        milliseconds(timeout_milliseconds);
 
+    // Block until a socket is readable, a request deadline passes or the
+    // deadline passes. Completion is detected on return, as responses and
+    // request timeouts are only handled in this loop.
     while (!poller.terminated() && requests_outstanding() &&
         steady_clock::now() < deadline)
     {
-        const auto identifiers = poller.wait(poll_timeout_milliseconds);
+        // Answer cached requests before blocking on the poll.
+        if (answer_cached_requests())
+            continue;
+
+        const auto identifiers = poller.wait(remaining(std::min(deadline,
+            request_timers_.next_expiry())));
 
         // Forward incoming client router requests to the server.
         if (identifiers.contains(router_.id()))
-            forward_message(router_, socket_);
+            forward_request();
 
         // Process server responses.
-        if (identifiers.contains(socket_.id()))
-            process_response(socket_);
+        process_responses(identifiers);
+
+        // Fail requests that have passed their own deadlines.
+        expire_requests();
+
+        // Send held requests into the window opened by completions.
+        release_requests();
     }
 
     // Timeout or otherwise notify any remaining requests.
@@ -222,6 +734,235 @@ void obelisk_client::wait(uint32_t timeout_milliseconds)
             error::channel_timeout : error::operation_failed);
 }
 
+// Reactor.
+//-----------------------------------------------------------------------------
+
+bool obelisk_client::start()
+{
+    if (reactor_.joinable())
+        return false;
+
+    // The doorbell endpoint is unique to this instance within the context.
+    if (!doorbell_bound_)
+    {
+        const config::endpoint doorbell("inproc://doorbell_" +
+            std::to_string(reinterpret_cast<uintptr_t>(this)));
+
+        if (doorbell_.bind(doorbell) || doorbell_sender_.connect(doorbell))
+            return false;
+
+        doorbell_bound_ = true;
+    }
+
+    stopping_ = false;
+    running_ = true;
+    reactor_ = std::thread(&obelisk_client::run_reactor, this);
+    return true;
+}
+
+void obelisk_client::stop()
+{
+    if (!reactor_.joinable())
+        return;
+
+    stopping_ = true;
+    ring_doorbell();
+    reactor_.join();
+    running_ = false;
+
+    // Requests still queued or pending can no longer be answered.
+    submission request;
+    while (submissions_.pop(request))
+        add_handler(request);
+
+    if (requests_outstanding())
+        clear_outstanding_requests(error::service_stopped);
+}
+
+void obelisk_client::run_reactor()
+{
+    zmq::poller poller;
+    poller.add(doorbell_);
+
+    for (const auto connection: connections_)
+        poller.add(*connection);
+
+    if (!direct_send_)
+        poller.add(router_);
+
+    while (!stopping_ && !poller.terminated())
+    {
+        drain_submissions();
+
+        // Handlers of cached requests may queue submissions, seen below.
+        answer_cached_requests();
+
+        // Arm the doorbell, then recheck the queue, so that a request queued
+        // before the doorbell was armed is not left waiting on the poll.
+        doorbell_armed_ = true;
+        if (!submissions_.empty())
+        {
+            doorbell_armed_ = false;
+            continue;
+        }
+
+        const auto identifiers = poller.wait(remaining(
+            request_timers_.next_expiry()));
+
+        if (identifiers.contains(doorbell_.id()))
+        {
+            zmq::message bell;
+            doorbell_.receive(bell);
+        }
+
+        // Forward incoming client router requests to the server.
+        if (identifiers.contains(router_.id()))
+            forward_request();
+
+        // Process server responses.
+        process_responses(identifiers);
+
+        // Fail requests that have passed their own deadlines.
+        expire_requests();
+
+        // Send held requests into the window opened by completions.
+        release_requests();
+    }
+
+    doorbell_armed_ = false;
+}
+
+void obelisk_client::drain_submissions()
+{
+    submission request;
+    while (submissions_.pop(request))
+        dispatch(request);
+}
+
+void obelisk_client::ring_doorbell()
+{
+    zmq::message bell;
+    bell.enqueue();
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(doorbell_lock_);
+    doorbell_sender_.send(bell);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool obelisk_client::bind_monitor_bell()
+{
+    if (monitor_bell_bound_)
+        return true;
+
+    // The bell endpoint is unique to this instance within the context.
+    const config::endpoint bell("inproc://monitor_bell_" +
+        std::to_string(reinterpret_cast<uintptr_t>(this)));
+
+    if (monitor_bell_.bind(bell) || monitor_bell_sender_.connect(bell))
+        return false;
+
+    monitor_bell_bound_ = true;
+    return true;
+}
+
+void obelisk_client::ring_monitor()
+{
+    if (!monitor_bell_armed_.exchange(false))
+        return;
+
+    zmq::message bell;
+    bell.enqueue();
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(monitor_bell_lock_);
+    monitor_bell_sender_.send(bell);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Arm the bell, then deliver, so that a block parsed or fetched after
+// delivery rings.
+void obelisk_client::deliver_blocks()
+{
+    if (!monitor_bell_bound_)
+        return;
+
+    monitor_bell_armed_ = true;
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    backfill_lock_.lock();
+    auto backfilled = std::move(backfilled_);
+    backfilled_.clear();
+    backfill_lock_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (auto& block: backfilled)
+        block_sequencer_.fetched(block.first, std::move(block.second));
+
+    if (sequence_blocks_)
+        block_sequencer_.retry();
+
+    if (block_decoder_ && on_block_update_)
+        block_decoder_->deliver(on_block_update_);
+}
+
+// Blocks may be tracked without a block subscription, and are then dropped.
+void obelisk_client::deliver_block(data_chunk&& data)
+{
+    if (on_block_view_update_)
+    {
+        on_block_view_update_({ std::move(data), true });
+    }
+    else if (!on_block_update_)
+    {
+        return;
+    }
+    else if (block_decoder_)
+    {
+        block_decoder_->push(std::move(data));
+    }
+    else
+    {
+        chain::block block;
+        block.from_data(data, true);
+        on_block_update_(block);
+    }
+}
+
+// Fetched blocks are queued for monitor(), as the fetch handler is invoked
+// by wait() or the reactor.
+void obelisk_client::fetch_missing_block(size_t height)
+{
+    const auto handler = [this, height](const code& ec,
+        const block_view& view)
+    {
+        const auto block = view.data();
+        auto data = ec ? data_chunk{} :
+            data_chunk{ block.begin(), block.end() };
+
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        backfill_lock_.lock();
+        backfilled_.emplace_back(height, std::move(data));
+        backfill_lock_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        ring_monitor();
+    };
+
+    blockchain_fetch_block_view(handler, static_cast<uint32_t>(height),
+        backfill_timeout_milliseconds);
+}
+
+void obelisk_client::fail_missing_block(size_t height)
+{
+    if (on_block_gap_)
+        on_block_gap_(height);
+}
+
 bool obelisk_client::subscribe_block(const config::endpoint& address,
     block_update_handler on_update)
 {
@@ -229,6 +970,21 @@ bool obelisk_client::subscribe_block(const config::endpoint& address,
     if (block_socket_.connect(host_address) == error::success)
     {
         on_block_update_ = on_update;
+        on_block_view_update_ = {};
+        return true;
+    }
+
+    return false;
+}
+
+bool obelisk_client::subscribe_block_view(const config::endpoint& address,
+    block_view_update_handler on_update)
+{
+    const auto host_address = address.to_string();
+    if (block_socket_.connect(host_address) == error::success)
+    {
+        on_block_view_update_ = on_update;
+        on_block_update_ = {};
         return true;
     }
 
@@ -236,12 +992,15 @@ bool obelisk_client::subscribe_block(const config::endpoint& address,
 }
 
 bool obelisk_client::subscribe_transaction(
-    const config::endpoint& address, transaction_update_handler on_update)
+    const config::endpoint& address, transaction_update_handler on_update,
+    feed_gap_handler on_gap)
 {
     const auto host_address = address.to_string();
     if (transaction_socket_.connect(host_address) == error::success)
     {
         on_transaction_update_ = on_update;
+        on_transaction_gap_ = on_gap;
+        transaction_sequenced_ = false;
         return true;
     }
 
@@ -251,18 +1010,34 @@ bool obelisk_client::subscribe_transaction(
 // Used by watch-* and subscribe-* commands, fires registered update handlers.
 void obelisk_client::monitor(uint32_t timeout_milliseconds)
 {
-    auto deadline = steady_clock::now() + milliseconds(timeout_milliseconds);
+    const auto deadline = steady_clock::now() +
+        milliseconds(timeout_milliseconds);
 
     zmq::poller poller;
-    poller.add(subscribe_router_);
     poller.add(subscribe_socket_);
     poller.add(block_socket_);
     poller.add(transaction_socket_);
 
+    if (!direct_send_)
+        poller.add(subscribe_router_);
+
+    if (monitor_bell_bound_)
+        poller.add(monitor_bell_);
+
     // A timeout of 0 will still have a chance to complete.
     do
     {
-        const auto identifiers = poller.wait(timeout_milliseconds);
+        deliver_blocks();
+
+        // Wake for a failed block fetch that is due to be retried.
+        const auto identifiers = poller.wait(remaining(sequence_blocks_ ?
+            std::min(deadline, block_sequencer_.next_retry()) : deadline));
+        if (identifiers.contains(monitor_bell_.id()))
+        {
+            zmq::message bell;
+            monitor_bell_.receive(bell);
+        }
+
         if (identifiers.contains(block_socket_.id()))
         {
             zmq::message message;
@@ -275,11 +1050,12 @@ void obelisk_client::monitor(uint32_t timeout_milliseconds)
             message.dequeue(sequence);
             message.dequeue(height);
             message.dequeue(data);
+            observe_height(height);
 
-            chain::block block;
-            block.from_data(data, true);
-
-            on_block_update_(block);
+            if (sequence_blocks_)
+                block_sequencer_.live(height, std::move(data));
+            else
+                deliver_block(std::move(data));
         }
 
         if (identifiers.contains(transaction_socket_.id()))
@@ -293,6 +1069,15 @@ void obelisk_client::monitor(uint32_t timeout_milliseconds)
             message.dequeue(sequence);
             message.dequeue(data);
 
+            // The sequence wraps, so the difference is taken in its width.
+            if (transaction_sequenced_ && sequence != transaction_sequence_ &&
+                on_transaction_gap_)
+                on_transaction_gap_(static_cast<uint16_t>(
+                    sequence - transaction_sequence_));
+
+            transaction_sequence_ = static_cast<uint16_t>(sequence + 1u);
+            transaction_sequenced_ = true;
+
             chain::transaction transaction;
             transaction.from_data(data, true, true);
 
@@ -310,23 +1095,34 @@ void obelisk_client::monitor(uint32_t timeout_milliseconds)
     } while (!poller.terminated() && subscribe_requests_outstanding() &&
         steady_clock::now() < deadline);
 
+    deliver_blocks();
+
     clear_outstanding_subscribe_requests((steady_clock::now() >= deadline) ?
         error::channel_timeout : error::operation_failed);
 }
 
 // Create a message and send it to the internal router for forwarding
-// to the server.
-bool obelisk_client::send_request(const std::string& command,
-    uint32_t id, const data_chunk& payload, bool subscription)
+// to the server, or directly to the server if so configured.
+bool obelisk_client::send_request(command type, uint32_t id,
+    const data_chunk& payload, bool subscription, size_t connection)
 {
     zmq::message message;
-    // First, add the required delimiter since we're sending to our
-    // internal router socket.
+
+    // The internal router forwards a request to the connection it names.
+    if (!direct_send_ && !subscription)
+        message.enqueue(to_chunk(to_little_endian(
+            static_cast<uint32_t>(connection))));
+
+    // Add the required delimiter, which is forwarded to the server.
     message.enqueue();
-    message.enqueue(to_chunk(command));
+    message.enqueue(command_frame(type));
     message.enqueue(to_chunk(to_little_endian(id)));
     message.enqueue(payload);
 
+    if (direct_send_)
+        return subscription ? !subscribe_socket_.send(message) :
+            !connections_[connection]->send(message);
+
     return subscription ? !subscribe_dealer_.send(message) :
         !dealer_.send(message);
 }
@@ -336,39 +1132,37 @@ bool obelisk_client::send_request(const std::string& command,
 
 void obelisk_client::attach_handlers()
 {
-    auto result_handler = [this](const std::string&, uint32_t id,
+    auto result_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = result_handlers_.find(id);
-        if (handler == result_handlers_.end())
+        obelisk_client::result_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
         istream_reader source(istream);
-        handler->second(source.read_error_code());
-        result_handlers_.erase(handler);
+        handler(source.read_error_code());
     };
 
-    auto version_handler = [this](const std::string&, uint32_t id,
+    auto version_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = version_handlers_.find(id);
-        if (handler == version_handlers_.end())
+        obelisk_client::version_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
         istream_reader source(istream);
         const auto ec = source.read_error_code();
         const auto version = source.read_bytes();
-        handler->second(ec, std::string(version.begin(), version.end()));
-        version_handlers_.erase(handler);
+        handler(ec, std::string(version.begin(), version.end()));
     };
 
-    auto transaction_handler = [this](const std::string&, uint32_t id,
+    auto transaction_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = transaction_handlers_.find(id);
-        if (handler == transaction_handlers_.end())
+        obelisk_client::transaction_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -376,43 +1170,44 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            transaction_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
+        // Objects are parsed from the reader over the payload, rather than
+        // from a copy of the payload remainder.
         chain::transaction tx;
-        if (!tx.from_data(source.read_bytes(), true, true))
+        if (!tx.from_data(source, true, true))
         {
-            handler->second(error::bad_stream, {});
-            transaction_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, tx);
-        transaction_handlers_.erase(handler);
+        handler(ec, tx);
     };
 
-    auto height_handler = [this](const std::string&, uint32_t id,
+    auto height_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = height_handlers_.find(id);
-        if (handler == height_handlers_.end())
+        obelisk_client::height_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
         istream_reader source(istream);
         const auto ec = source.read_error_code();
         const size_t height = source.read_4_bytes_little_endian();
-        handler->second(ec, height);
-        height_handlers_.erase(handler);
+        if (!ec)
+            observe_height(height);
+
+        handler(ec, height);
     };
 
-    auto block_header_handler = [this](const std::string&, uint32_t id,
+    auto block_header_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = block_header_handlers_.find(id);
-        if (handler == block_header_handlers_.end())
+        obelisk_client::block_header_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -420,57 +1215,61 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            block_header_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
         chain::header header;
-        if (!header.from_data(source.read_bytes()))
+        if (!header.from_data(source))
         {
-            handler->second(error::bad_stream, {});
-            block_header_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, header);
-        block_header_handlers_.erase(handler);
+        handler(ec, header);
     };
 
-    auto block_handler = [this](const std::string&, uint32_t id,
-        const data_chunk& payload)
-    {
-        auto handler = block_handlers_.find(id);
-        if (handler == block_handlers_.end())
+    auto block_handler = [this](command, uint32_t id,
+        const data_chunk& payload)
+    {
+        data_source istream(payload);
+        istream_reader source(istream);
+
+        // The payload is not shared on this path, so it is copied once.
+        obelisk_client::block_view_handler view_handler;
+        if (take_handler(id, view_handler))
+        {
+            answer_view(view_handler, std::make_shared<const data_chunk>(
+                payload));
+            return;
+        }
+
+        obelisk_client::block_handler handler;
+        if (!take_handler(id, handler))
             return;
 
-        data_source istream(payload);
-        istream_reader source(istream);
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            block_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
         chain::block block;
-        if (!block.from_data(source.read_bytes()))
+        if (!block.from_data(source))
         {
-            handler->second(error::bad_stream, {});
-            block_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, block);
-        block_handlers_.erase(handler);
+        handler(ec, block);
     };
 
-    auto compact_filter_handler = [this](const std::string&, uint32_t id,
+    auto compact_filter_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = compact_filter_handlers_.find(id);
-        if (handler == compact_filter_handlers_.end())
+        obelisk_client::compact_filter_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -478,28 +1277,25 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            compact_filter_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
         message::compact_filter response;
-        if (!response.from_data(source.read_bytes()))
+        if (!response.from_data(source))
         {
-            handler->second(error::bad_stream, {});
-            compact_filter_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, response);
-        compact_filter_handlers_.erase(handler);
+        handler(ec, response);
     };
 
-    auto compact_filter_checkpoint_handler = [this](const std::string&,
+    auto compact_filter_checkpoint_handler = [this](command,
         uint32_t id, const data_chunk& payload)
     {
-        auto handler = compact_filter_checkpoint_handlers_.find(id);
-        if (handler == compact_filter_checkpoint_handlers_.end())
+        obelisk_client::compact_filter_checkpoint_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -507,29 +1303,26 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            compact_filter_checkpoint_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
         message::compact_filter_checkpoint response;
         const auto version = message::compact_filter_checkpoint::version_minimum;
-        if (!response.from_data(version, source.read_bytes()))
+        if (!response.from_data(version, source))
         {
-            handler->second(error::bad_stream, {});
-            compact_filter_checkpoint_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, response);
-        compact_filter_checkpoint_handlers_.erase(handler);
+        handler(ec, response);
     };
 
-    auto compact_filter_headers_handler = [this](const std::string&,
+    auto compact_filter_headers_handler = [this](command,
         uint32_t id, const data_chunk& payload)
     {
-        auto handler = compact_filter_headers_handlers_.find(id);
-        if (handler == compact_filter_headers_handlers_.end())
+        obelisk_client::compact_filter_headers_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -537,29 +1330,26 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         if (ec)
         {
-            handler->second(ec, {});
-            compact_filter_headers_handlers_.erase(handler);
+            handler(ec, {});
             return;
         }
 
         message::compact_filter_headers response;
         const auto version = message::compact_filter_headers::version_minimum;
-        if (!response.from_data(version, source.read_bytes()))
+        if (!response.from_data(version, source))
         {
-            handler->second(error::bad_stream, {});
-            compact_filter_headers_handlers_.erase(handler);
+            handler(error::bad_stream, {});
             return;
         }
 
-        handler->second(ec, response);
-        compact_filter_headers_handlers_.erase(handler);
+        handler(ec, response);
     };
 
-    auto transaction_index_handler = [this](const std::string&, uint32_t id,
+    auto transaction_index_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = transaction_index_handlers_.find(id);
-        if (handler == transaction_index_handlers_.end())
+        obelisk_client::transaction_index_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         data_source istream(payload);
@@ -567,119 +1357,50 @@ void obelisk_client::attach_handlers()
         const auto ec = source.read_error_code();
         const auto block_height = source.read_4_bytes_little_endian();
         const auto index = source.read_4_bytes_little_endian();
-        handler->second(ec, block_height, index);
-        transaction_index_handlers_.erase(handler);
+        handler(ec, block_height, index);
     };
 
-    auto history_handler = [this](const std::string&, uint32_t id,
+    auto history_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = history_handlers_.find(id);
-        if (handler == history_handlers_.end())
-            return;
-
-        payment_record payment;
-        payment_record::list records;
-
-        data_source istream(payload);
-        istream_reader source(istream);
-        const auto ec = source.read_error_code();
-        while (!source.is_exhausted())
+        obelisk_client::history_chunks chunks;
+        if (take_handler(id, chunks))
         {
-            if (!payment.from_data(source, true))
-            {
-                handler->second(ec, {});
-                history_handlers_.erase(handler);
-                return;
-            }
-
-            records.push_back(payment);
+            deliver_history(payload, chunks);
+            return;
         }
 
-        history::list result;
-        result.reserve(records.size());
-        std::unordered_multimap<uint64_t, size_t> output_checksums;
-
-        // Process and remove all outputs.
-        for (const auto& record: records)
+        obelisk_client::history_columns_handler columns_handler;
+        if (take_handler(id, columns_handler))
         {
-            if (!record.is_output())
-                continue;
-
-            output_point output{ record.hash(), record.index() };
-            const auto temporary_checksum = output.checksum();
-            result.emplace_back(
-                output,
-                record.height(),
-                record.data(),
-                input_point{ null_hash, chain::point::null_index },
-                temporary_checksum);
-
-            output_checksums.emplace(temporary_checksum, result.size() - 1);
+            history_columns columns;
+            const auto ec = decode_history(payload, columns);
+            columns_handler(ec, columns);
+            return;
         }
 
-        // TODO: reduce to output set with distinct checksums, as a fault signal.
-        ////std::sort(result.begin(), result.end());
-        ////result.erase(std::unique(result.begin(), result.end()), result.end());
-
-        // All outputs have been handled, process the spends.
-        for (auto& record: records)
+        obelisk_client::payment_handler payment_handler;
+        if (take_handler(id, payment_handler))
         {
-            if (record.is_output())
-                continue;
-
-            auto found = false;
-            const auto matches = output_checksums.equal_range(record.data());
-
-            // Update outputs with the corresponding spends.
-            // This relies on the lucky avoidance of checksum hash collisions :<.
-            // Ordering is insufficient since the server may write concurrently.
-            for (auto match = matches.first; match != matches.second; match++)
-            {
-                auto& history = result[match->second];
-
-                // The temporary_checksum is a union with spend_height, so we must
-                // guard against matching temporary_checksum unless spend is null.
-                if (history.spend.is_null())
-                {
-                    // Move the spend to the row of its correlated output.
-                    history.spend = input_point{ record.hash(), record.index() };
-                    history.spend_height = record.height();
-                    found = true;
-                    break;
-                }
-            }
-
-            // This will only happen if the history height cutoff comes between an
-            // output and its spend. In this case we return just the spend.
-            // This is not strictly sufficient because of checksum hash collisions,
-            // So this miscorrelation must be discarded as a fault signal.
-            if (!found)
-            {
-                result.emplace_back(
-                    output_point{ null_hash, chain::point::null_index },
-                    max_size_t,
-                    max_uint64,
-                    input_point{ record.hash(), record.index() },
-                    record.height());
-            }
+            payment_record::list payments;
+            const auto ec = decode_payments(payload, payments);
+            payment_handler(ec, payments);
+            return;
         }
 
-        result.shrink_to_fit();
-
-        // Clear all remaining checksums from unspent rows.
-        for (auto& history: result)
-            if (history.spend.is_null())
-                history.spend_height = max_uint64;
+        obelisk_client::history_handler handler;
+        if (!take_handler(id, handler))
+            return;
 
-        handler->second(ec, result);
-        history_handlers_.erase(handler);
+        history::list rows;
+        const auto ec = decode_history(payload, rows);
+        handler(ec, rows);
     };
 
     // This handler locks subscription_handlers_ while running to avoid
     // subscription handler state from changing while running (called from
     // process_response).
-    auto notification_handler = [this](const std::string&, uint32_t id,
+    auto notification_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
         // Critical Section.
@@ -733,7 +1454,7 @@ void obelisk_client::attach_handlers()
     // This handler locks subscription_handlers_ while running to avoid
     // (un)subscription handler state from changing while running (called from
     // process_response).
-    auto unsubscribe_handler = [this](const std::string&, uint32_t id,
+    auto unsubscribe_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
         // Critical Section.
@@ -766,11 +1487,11 @@ void obelisk_client::attach_handlers()
         terminate_unsubscriber(subscription);
     };
 
-    auto hash_list_handler = [this](const std::string&, uint32_t id,
+    auto hash_list_handler = [this](command, uint32_t id,
         const data_chunk& payload)
     {
-        auto handler = hash_list_handlers_.find(id);
-        if (handler == hash_list_handlers_.end())
+        obelisk_client::hash_list_handler handler;
+        if (!take_handler(id, handler))
             return;
 
         hash_list hashes;
@@ -781,73 +1502,335 @@ void obelisk_client::attach_handlers()
         while (!source.is_exhausted())
             hashes.push_back(source.read_hash());
 
-        handler->second(ec, hashes);
-        hash_list_handlers_.erase(handler);
+        handler(ec, hashes);
     };
 
-#define REGISTER_HANDLER(command, handler) \
-    command_handlers_[command] = handler
+#define REGISTER_HANDLER(type, handler) \
+    command_handlers_[static_cast<size_t>(command::type)] = handler
 
-    REGISTER_HANDLER("transaction_pool.broadcast", result_handler);
-    REGISTER_HANDLER("transaction_pool.validate2", result_handler);
-    REGISTER_HANDLER("transaction_pool.fetch_transaction", transaction_handler);
-    REGISTER_HANDLER("transaction_pool.fetch_transaction2",
+    REGISTER_HANDLER(transaction_pool_broadcast, result_handler);
+    REGISTER_HANDLER(transaction_pool_validate2, result_handler);
+    REGISTER_HANDLER(transaction_pool_fetch_transaction, transaction_handler);
+    REGISTER_HANDLER(transaction_pool_fetch_transaction2,
         transaction_handler);
-    REGISTER_HANDLER("blockchain.broadcast", result_handler);
-    REGISTER_HANDLER("blockchain.validate", result_handler);
-    REGISTER_HANDLER("blockchain.fetch_transaction", transaction_handler);
-    REGISTER_HANDLER("blockchain.fetch_transaction2", transaction_handler);
-    REGISTER_HANDLER("blockchain.fetch_last_height", height_handler);
-    REGISTER_HANDLER("blockchain.fetch_block", block_handler);
-    REGISTER_HANDLER("blockchain.fetch_block_header", block_header_handler);
-    REGISTER_HANDLER("blockchain.fetch_block_height", height_handler);
-    REGISTER_HANDLER("blockchain.fetch_compact_filter", compact_filter_handler);
-    REGISTER_HANDLER("blockchain.fetch_compact_filter_checkpoint", compact_filter_checkpoint_handler);
-    REGISTER_HANDLER("blockchain.fetch_compact_filter_headers", compact_filter_headers_handler);
-    REGISTER_HANDLER("blockchain.fetch_transaction_index",
+    REGISTER_HANDLER(blockchain_broadcast, result_handler);
+    REGISTER_HANDLER(blockchain_validate, result_handler);
+    REGISTER_HANDLER(blockchain_fetch_transaction, transaction_handler);
+    REGISTER_HANDLER(blockchain_fetch_transaction2, transaction_handler);
+    REGISTER_HANDLER(blockchain_fetch_last_height, height_handler);
+    REGISTER_HANDLER(blockchain_fetch_block, block_handler);
+    REGISTER_HANDLER(blockchain_fetch_block_header, block_header_handler);
+    REGISTER_HANDLER(blockchain_fetch_block_height, height_handler);
+    REGISTER_HANDLER(blockchain_fetch_compact_filter, compact_filter_handler);
+    REGISTER_HANDLER(blockchain_fetch_compact_filter_checkpoint, compact_filter_checkpoint_handler);
+    REGISTER_HANDLER(blockchain_fetch_compact_filter_headers, compact_filter_headers_handler);
+    REGISTER_HANDLER(blockchain_fetch_transaction_index,
         transaction_index_handler);
-    REGISTER_HANDLER("blockchain.fetch_history4", history_handler);
-    REGISTER_HANDLER("blockchain.fetch_block_transaction_hashes", hash_list_handler);
-    REGISTER_HANDLER("subscribe.key", notification_handler);
-    REGISTER_HANDLER("notification.key", notification_handler);
-    REGISTER_HANDLER("unsubscribe.key", unsubscribe_handler);
-    REGISTER_HANDLER("server.version", version_handler);
+    REGISTER_HANDLER(blockchain_fetch_history4, history_handler);
+    REGISTER_HANDLER(blockchain_fetch_block_transaction_hashes, hash_list_handler);
+    REGISTER_HANDLER(subscribe_key, notification_handler);
+    REGISTER_HANDLER(notification_key, notification_handler);
+    REGISTER_HANDLER(unsubscribe_key, unsubscribe_handler);
+    REGISTER_HANDLER(server_version, version_handler);
 
 #undef REGISTER_HANDLER
 }
 
-void obelisk_client::handle_immediate(const std::string& command, uint32_t id,
+void obelisk_client::handle_immediate(command type, uint32_t id,
     const code& ec)
 {
-    auto command_handler = command_handlers_.find(command);
-    if (command_handler == command_handlers_.end())
-        return;
-
     const auto payload = build_chunk(
     {
         to_little_endian(static_cast<uint32_t>(ec.value()))
     });
 
-    command_handler->second(command, id, payload);
+    handle_response(type, id, payload);
+}
+
+template <typename Handler>
+bool obelisk_client::take_handler(uint32_t id, Handler& out)
+{
+    // The handler is removed before it is invoked, so that it may reenter.
+    auto pending = request_handlers_.find(id);
+    if (pending == nullptr ||
+        !std::holds_alternative<Handler>(pending->handler))
+        return false;
+
+    out = std::move(std::get<Handler>(pending->handler));
+    const auto followers = std::move(pending->followers);
+
+    if (!pending->key.empty())
+    {
+        const auto leader = coalescing_.find(pending->key);
+        if (leader != coalescing_.end() && leader->second == id)
+            coalescing_.erase(leader);
+    }
+
+    if (pending->connection != unsent)
+    {
+        const auto connection = pending->connection;
+        limits_[connection].sample(steady_clock::now() - pending->sent,
+            outstanding_[connection]);
+
+        --outstanding_[connection];
+        --in_flight_;
+    }
+
+    request_handlers_.erase(id);
+
+    // Only function handlers are coalesced, so only these have followers.
+    // A follower that has expired is no longer pending.
+    if constexpr (is_function_handler<Handler>::value)
+    {
+        std::vector<Handler> handlers;
+        for (const auto follower: followers)
+        {
+            pending = request_handlers_.find(follower);
+            if (pending == nullptr ||
+                !std::holds_alternative<Handler>(pending->handler))
+                continue;
+
+            if (handlers.empty())
+                handlers.push_back(std::move(out));
+
+            handlers.push_back(std::move(std::get<Handler>(pending->handler)));
+            request_handlers_.erase(follower);
+        }
+
+        if (!handlers.empty())
+            out = join_handlers(std::move(handlers));
+    }
+
+    return true;
+}
+
+void obelisk_client::add_handler(submission& request)
+{
+    const auto deadline = request.timeout_milliseconds == 0 ?
+        steady_clock::time_point::max() :
+        steady_clock::now() + milliseconds(request.timeout_milliseconds);
+
+    request_handlers_.insert(request.id,
+    {
+        std::move(request.handler),
+        unsent,
+        {},
+        deadline,
+        std::move(request.key),
+        request.cacheable,
+        {}
+    });
+
+    if (request.timeout_milliseconds != 0)
+        request_timers_.schedule(request.id, request.type, deadline);
+}
+
+void obelisk_client::submit(command type, data_chunk&& payload,
+    request_handler&& handler, uint32_t timeout_milliseconds,
+    data_chunk&& key, bool cacheable, response_cache::value&& cached)
+{
+    submission request
+    {
+        type,
+        ++last_request_index_,
+        std::move(payload),
+        std::move(handler),
+        timeout_milliseconds,
+        std::move(key),
+        cacheable,
+        std::move(cached)
+    };
+
+    if (!running_)
+    {
+        dispatch(request);
+        return;
+    }
+
+    // The reactor thread sends the request, and is woken only if idle.
+    submissions_.push(std::move(request));
+
+    if (doorbell_armed_.exchange(false))
+        ring_doorbell();
+}
+
+// Held requests are sent before new ones, so the window preserves order.
+// A cached request is answered by the loop, not within its fetcher, so that
+// a handler that fetches again does not recurse.
+void obelisk_client::dispatch(submission& request)
+{
+    if (request.cached)
+    {
+        request.cacheable = false;
+        add_handler(request);
+        cached_answers_.push_back(
+        {
+            request.type,
+            request.id,
+            std::move(request.cached)
+        });
+
+        return;
+    }
+
+    if (!request.key.empty())
+    {
+        if (coalesce(request))
+            return;
+
+        coalescing_[request.key] = request.id;
+    }
+
+    add_handler(request);
+
+    if (held_requests_.empty() && window_open())
+    {
+        transmit(request.type, request.id, request.payload);
+        return;
+    }
+
+    held_requests_.push_back(
+    {
+        request.type,
+        request.id,
+        std::move(request.payload)
+    });
+
+    set_backlogged(true);
+}
+
+// The request joins only a request whose handler it can follow, as a block
+// and a block view are fetched by the same request but parsed apart. It
+// joins only a request that it does not outlive, so that it is not failed
+// by an earlier deadline, and is pending under its own id with its own
+// deadline, so that it is failed by that deadline alone.
+bool obelisk_client::coalesce(submission& request)
+{
+    const auto leader = coalescing_.find(request.key);
+    if (leader == coalescing_.end())
+        return false;
+
+    const auto pending = request_handlers_.find(leader->second);
+    if (pending == nullptr ||
+        pending->handler.index() != request.handler.index())
+        return false;
+
+    const auto deadline = request.timeout_milliseconds == 0 ?
+        steady_clock::time_point::max() :
+        steady_clock::now() + milliseconds(request.timeout_milliseconds);
+
+    if (deadline > pending->deadline)
+        return false;
+
+    pending->followers.push_back(request.id);
+    request.key.clear();
+    request.cacheable = false;
+    add_handler(request);
+    return true;
+}
+
+void obelisk_client::transmit(command type, uint32_t id,
+    const data_chunk& payload)
+{
+    const auto connection = select_connection();
+    const auto pending = request_handlers_.find(id);
+    pending->connection = connection;
+    pending->sent = steady_clock::now();
+    ++outstanding_[connection];
+    ++in_flight_;
+
+    if (!send_request(type, id, payload, false, connection))
+        handle_immediate(type, id, error::network_unreachable);
+}
+
+// Answers queued while answering are left to the next call, so handlers
+// that fetch cached responses in turn are answered iteratively.
+bool obelisk_client::answer_cached_requests()
+{
+    if (cached_answers_.empty())
+        return false;
+
+    auto answers = std::move(cached_answers_);
+    cached_answers_.clear();
+
+    for (const auto& answer: answers)
+        handle_response(answer.type, answer.id, answer.response);
+
+    return true;
+}
+
+// A held request that has timed out has no handler and is dropped unsent.
+void obelisk_client::release_requests()
+{
+    while (!held_requests_.empty() && window_open())
+    {
+        const auto request = std::move(held_requests_.front());
+        held_requests_.pop_front();
+
+        if (request_handlers_.find(request.id) != nullptr)
+            transmit(request.type, request.id, request.payload);
+    }
+
+    if (held_requests_.empty())
+        set_backlogged(false);
+}
+
+bool obelisk_client::window_open() const
+{
+    if (window_ != 0 && in_flight_ >= window_)
+        return false;
+
+    for (size_t connection = 0; connection < connections_.size();
+        ++connection)
+        if (admits(connection))
+            return true;
+
+    return false;
+}
+
+bool obelisk_client::admits(size_t connection) const
+{
+    return !adaptive_ || outstanding_[connection] < limits_[connection].limit();
+}
+
+void obelisk_client::set_backlogged(bool backlogged)
+{
+    if (backlogged_.exchange(backlogged) != backlogged && on_backpressure_)
+        on_backpressure_(backlogged);
+}
+
+// Timers are not cancelled on response, so the timer of a request that has
+// been answered finds no handler and is ignored by handle_immediate.
+void obelisk_client::expire_requests()
+{
+    if (request_timers_.empty())
+        return;
+
+    timer_wheel::timers expired;
+    request_timers_.advance(steady_clock::now(), expired);
+
+    for (const auto& timer: expired)
+    {
+        // A sent request that expires backs off the limit of its connection,
+        // and is released from it so that it is not also sampled.
+        const auto pending = request_handlers_.find(timer.id);
+        if (pending != nullptr && pending->connection != unsent)
+        {
+            const auto connection = pending->connection;
+            limits_[connection].drop();
+            --outstanding_[connection];
+            --in_flight_;
+            pending->connection = unsent;
+        }
+
+        handle_immediate(timer.type, timer.id, error::channel_timeout);
+    }
 }
 
 bool obelisk_client::requests_outstanding()
 {
-    // We have requests outstanding if any of the handler maps are not
-    // empty, except update/notification handlers.
-    return
-        !result_handlers_.empty() ||
-        !height_handlers_.empty() ||
-        !transaction_index_handlers_.empty() ||
-        !block_handlers_.empty() ||
-        !block_header_handlers_.empty() ||
-        !transaction_handlers_.empty() ||
-        !hash_list_handlers_.empty() ||
-        !history_handlers_.empty() ||
-        !version_handlers_.empty() ||
-        !compact_filter_handlers_.empty() ||
-        !compact_filter_checkpoint_handlers_.empty() ||
-        !compact_filter_headers_handlers_.empty();
+    // Update/notification handlers are not held in the request table.
+    return !request_handlers_.empty();
 }
 
 // We have subscribe requests outstanding if the subscription handler map is not
@@ -863,31 +1846,45 @@ bool obelisk_client::subscribe_requests_outstanding()
 
 void obelisk_client::clear_outstanding_requests(const code& ec)
 {
-#define INVOKE_HANDLER_0 handler.second(ec)
-#define INVOKE_HANDLER_1 handler.second(ec, {})
-#define INVOKE_HANDLER_2 handler.second(ec, {}, {})
-
-#define CLEAR_OUTSTANDING(handlers, ec, handler_version) \
-    for (auto& handler: handlers) \
-        INVOKE_HANDLER_##handler_version; \
-    handlers.clear()
-
-    // Clear the handler maps, but first fire the handlers with the
-    // specified error.
-    CLEAR_OUTSTANDING(result_handlers_, ec, 0);
-    CLEAR_OUTSTANDING(height_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(transaction_index_handlers_, ec, 2);
-    CLEAR_OUTSTANDING(block_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(block_header_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(transaction_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(hash_list_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(history_handlers_, ec, 1);
-    CLEAR_OUTSTANDING(version_handlers_, ec, 1);
-
-#undef CLEAR_OUTSTANDING
-#undef INVOKE_HANDLER_0
-#undef INVOKE_HANDLER_1
-#undef INVOKE_HANDLER_2
+    // Timers of the cleared requests are dropped, so that handlers may
+    // schedule new ones.
+    request_timers_.clear();
+
+    // Held requests are failed with the table, and late responses to sent
+    // requests find no handler, so the window is emptied first.
+    held_requests_.clear();
+    cached_answers_.clear();
+    std::fill(outstanding_.begin(), outstanding_.end(), 0);
+    in_flight_ = 0;
+    set_backlogged(false);
+
+    coalescing_.clear();
+
+    // Fire each pending handler with the specified error, emptying the table.
+    request_handlers_.drain([&ec](uint32_t, pending_request& pending)
+    {
+        const auto fail = [&ec](auto& handler)
+        {
+            typedef std::decay_t<decltype(handler)> handler_type;
+
+            if constexpr (std::is_same_v<handler_type,
+                obelisk_client::result_handler>)
+                handler(ec);
+            else if constexpr (std::is_same_v<handler_type,
+                obelisk_client::transaction_index_handler>)
+                handler(ec, {}, {});
+            else if constexpr (std::is_same_v<handler_type,
+                obelisk_client::history_chunks>)
+                handler.handler(ec, {}, true);
+            else if constexpr (std::is_same_v<handler_type,
+                obelisk_client::history_columns_handler>)
+                handler(ec, history_columns{});
+            else
+                handler(ec, {});
+        };
+
+        std::visit(fail, pending.handler);
+    });
 }
 
 void obelisk_client::clear_outstanding_subscribe_requests(const code& ec)
@@ -909,165 +1906,289 @@ void obelisk_client::clear_outstanding_subscribe_requests(const code& ec)
 // Fetchers.
 //-----------------------------------------------------------------------------
 
-void obelisk_client::server_version(version_handler handler)
+void obelisk_client::server_version(version_handler handler,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "server.version";
-    static const data_chunk empty{};
-    const auto id = ++last_request_index_;
-    version_handlers_[id] = handler;
-    if (!send_request(command, id, empty))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::server_version;
+    submit(request, {}, std::move(handler), timeout_milliseconds);
 }
 
 // This will fail if a witness tx is sent to a < v3.4 (pre-witness) server.
 void obelisk_client::transaction_pool_broadcast(result_handler handler,
-    const chain::transaction& tx)
+    const chain::transaction& tx, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "transaction_pool.broadcast";
-    const auto id = ++last_request_index_;
-    result_handlers_[id] = handler;
-    if (!send_request(command, id, tx.to_data(true, true)))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::transaction_pool_broadcast;
+    submit(request, tx.to_data(true, true), std::move(handler),
+        timeout_milliseconds);
 }
 
 // This will fail if a witness tx is sent to a < v3.4 (pre-witness) server.
 void obelisk_client::transaction_pool_validate2(result_handler handler,
-    const chain::transaction& tx)
+    const chain::transaction& tx, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "transaction_pool.validate2";
-    const auto id = ++last_request_index_;
-    result_handlers_[id] = handler;
-    if (!send_request(command, id, tx.to_data(true, true)))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::transaction_pool_validate2;
+    submit(request, tx.to_data(true, true), std::move(handler),
+        timeout_milliseconds);
 }
 
 void obelisk_client::transaction_pool_fetch_transaction(
-    transaction_handler handler, const hash_digest& tx_hash)
+    transaction_handler handler, const hash_digest& tx_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "transaction_pool.fetch_transaction";
-    const auto data = build_chunk({ tx_hash });
-    const auto id = ++last_request_index_;
-    transaction_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::transaction_pool_fetch_transaction;
+    auto data = build_chunk({ tx_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::transaction_pool_fetch_transaction2(
-     transaction_handler handler, const hash_digest& tx_hash)
+     transaction_handler handler, const hash_digest& tx_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "transaction_pool.fetch_transaction2";
-    const auto data = build_chunk({ tx_hash });
-    const auto id = ++last_request_index_;
-    transaction_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::transaction_pool_fetch_transaction2;
+    auto data = build_chunk({ tx_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_broadcast(result_handler handler,
-    const chain::block& block)
+    const chain::block& block, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.broadcast";
-    const auto id = ++last_request_index_;
-    result_handlers_[id] = handler;
-    if (!send_request(command, id, block.to_data()))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_broadcast;
+    submit(request, block.to_data(), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_validate(result_handler handler,
-    const chain::block& block)
+    const chain::block& block, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.validate";
-    const auto id = ++last_request_index_;
-    result_handlers_[id] = handler;
-    if (!send_request(command, id, block.to_data()))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_validate;
+    submit(request, block.to_data(), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_transaction(
-     transaction_handler handler, const hash_digest& tx_hash)
+     transaction_handler handler, const hash_digest& tx_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_transaction";
-    const auto data = build_chunk({ tx_hash });
-    const auto id = ++last_request_index_;
-    transaction_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_transaction;
+    auto data = build_chunk({ tx_hash });
+
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, true);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), true, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_transaction2(
-     transaction_handler handler, const hash_digest& tx_hash)
+     transaction_handler handler, const hash_digest& tx_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_transaction2";
-    const auto data = build_chunk({ tx_hash });
-    const auto id = ++last_request_index_;
-    transaction_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_transaction2;
+    auto data = build_chunk({ tx_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
-void obelisk_client::blockchain_fetch_last_height(height_handler handler)
+void obelisk_client::blockchain_fetch_last_height(height_handler handler,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_last_height";
-    const data_chunk data{};
-    const auto id = ++last_request_index_;
-    height_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_last_height;
+    submit(request, {}, std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_block(block_handler handler,
-    uint32_t height)
+    uint32_t height, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block";
-    const auto data = build_chunk({ to_little_endian<uint32_t>(height) });
-    const auto id = ++last_request_index_;
-    block_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block;
+    auto data = build_chunk({ to_little_endian<uint32_t>(height) });
+
+    const auto cacheable = buried(height);
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, cacheable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), cacheable, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_block(block_handler handler,
-    const hash_digest& block_hash)
+    const hash_digest& block_hash, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block";
-    const auto data = build_chunk({ block_hash });
-    const auto id = ++last_request_index_;
-    block_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block;
+    auto data = build_chunk({ block_hash });
+
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, true);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), true, std::move(cached));
+}
+
+void obelisk_client::blockchain_fetch_block_view(block_view_handler handler,
+    uint32_t height, uint32_t timeout_milliseconds)
+{
+    static constexpr auto request = command::blockchain_fetch_block;
+    auto data = build_chunk({ to_little_endian<uint32_t>(height) });
+
+    const auto cacheable = buried(height);
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, cacheable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), cacheable, std::move(cached));
+}
+
+void obelisk_client::blockchain_fetch_block_view(block_view_handler handler,
+    const hash_digest& block_hash, uint32_t timeout_milliseconds)
+{
+    static constexpr auto request = command::blockchain_fetch_block;
+    auto data = build_chunk({ block_hash });
+
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, true);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), true, std::move(cached));
+}
+
+// Requests are issued only while fewer than window blocks are undelivered,
+// which bounds the blocks buffered for reordering. The first requests are
+// issued by the caller while the reactor may be answering them.
+struct obelisk_client::block_range
+{
+    block_range_handler handler;
+    size_t last;
+    size_t window;
+    uint32_t timeout_milliseconds;
+    size_t next_request;
+    size_t next_delivery;
+    std::map<size_t, chain::block> buffer;
+    bool failed;
+
+    // Protects the range.
+    std::mutex mutex;
+};
+
+void obelisk_client::blockchain_fetch_blocks(block_range_handler handler,
+    uint32_t first_height, uint32_t last_height, size_t window,
+    uint32_t timeout_milliseconds)
+{
+    if (first_height > last_height)
+    {
+        handler(error::operation_failed, first_height, {});
+        return;
+    }
+
+    const auto range = std::make_shared<block_range>();
+    range->handler = std::move(handler);
+    range->last = last_height;
+    range->window = std::max<size_t>(window, 1);
+    range->timeout_milliseconds = timeout_milliseconds;
+    range->next_request = first_height;
+    range->next_delivery = first_height;
+    range->failed = false;
+
+    fetch_range_blocks(range);
+}
+
+// Heights are claimed within the lock and fetched outside it, as a request
+// that fails to send is answered within its fetcher.
+void obelisk_client::fetch_range_blocks(const block_range_ptr& range)
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    range->mutex.lock();
+    const auto first = range->next_request;
+    while (!range->failed && range->next_request <= range->last &&
+        range->next_request - range->next_delivery < range->window)
+        ++range->next_request;
+
+    const auto last = range->next_request;
+    const auto timeout_milliseconds = range->timeout_milliseconds;
+    range->mutex.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (auto height = first; height < last; ++height)
+    {
+        const auto handler = [this, range, height](const code& ec,
+            const chain::block& block)
+        {
+            handle_range_block(range, height, ec, block);
+        };
+
+        blockchain_fetch_block(handler, static_cast<uint32_t>(height),
+            timeout_milliseconds);
+    }
+}
+
+// Blocks are delivered within the lock, which orders their delivery.
+void obelisk_client::handle_range_block(const block_range_ptr& range,
+    size_t height, const code& ec, const chain::block& block)
+{
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(range->mutex);
+
+    if (range->failed)
+        return;
+
+    if (ec)
+    {
+        range->failed = true;
+        range->buffer.clear();
+        range->handler(ec, height, {});
+        return;
+    }
+
+    // A block out of order is copied into the buffer, as it cannot be
+    // delivered, and opens no space in the window.
+    if (height != range->next_delivery)
+    {
+        range->buffer.emplace(height, block);
+        return;
+    }
+
+    range->handler(ec, height, block);
+    ++range->next_delivery;
+
+    auto it = range->buffer.begin();
+    while (it != range->buffer.end() && it->first == range->next_delivery)
+    {
+        range->handler(ec, it->first, it->second);
+        ++range->next_delivery;
+        it = range->buffer.erase(it);
+    }
+
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    fetch_range_blocks(range);
 }
 
 void obelisk_client::blockchain_fetch_block_header(
-    block_header_handler handler, uint32_t height)
+    block_header_handler handler, uint32_t height,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block_header";
-    const auto data = build_chunk({ to_little_endian<uint32_t>(height) });
-    const auto id = ++last_request_index_;
-    block_header_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block_header;
+    auto data = build_chunk({ to_little_endian<uint32_t>(height) });
+
+    const auto cacheable = buried(height);
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, cacheable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), cacheable, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_block_header(block_header_handler handler,
-    const hash_digest& block_hash)
+    const hash_digest& block_hash, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block_header";
-    const auto data = build_chunk({ block_hash });
-    const auto id = ++last_request_index_;
-    block_header_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block_header;
+    auto data = build_chunk({ block_hash });
+
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, true);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), true, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_transaction_index(
-    transaction_index_handler handler, const hash_digest& tx_hash)
+    transaction_index_handler handler, const hash_digest& tx_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_transaction_index";
-    const auto data = build_chunk({ tx_hash });
-    const auto id = ++last_request_index_;
-    transaction_index_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_transaction_index;
+    auto data = build_chunk({ tx_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 // blockchain.fetch_history4 (v4.0) request accepts key instead of
@@ -1076,38 +2197,91 @@ void obelisk_client::blockchain_fetch_transaction_index(
 // blockchain.fetch_history2 (v3.0) ignored version and is obsoleted in v3.1.
 // blockchain.fetch_history (v1/v2) used hash reversal and is obsoleted in v3.
 void obelisk_client::blockchain_fetch_history4(history_handler handler,
-    const hash_digest& key, uint32_t from_height)
+    const hash_digest& key, uint32_t from_height,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_history4";
+    static constexpr auto request = command::blockchain_fetch_history4;
 
-    const auto data = build_chunk(
+    auto data = build_chunk(
     {
         key,
         to_little_endian<uint32_t>(from_height)
     });
 
-    const auto id = ++last_request_index_;
-    history_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
+}
+
+void obelisk_client::blockchain_fetch_history4_chunks(
+    history_chunk_handler handler, const hash_digest& key, size_t chunk_rows,
+    uint32_t from_height, uint32_t timeout_milliseconds)
+{
+    static constexpr auto request = command::blockchain_fetch_history4;
+
+    auto data = build_chunk(
+    {
+        key,
+        to_little_endian<uint32_t>(from_height)
+    });
+
+    submit(request, std::move(data),
+        history_chunks{ std::move(handler), chunk_rows },
+        timeout_milliseconds);
+}
+
+void obelisk_client::blockchain_fetch_history4_columns(
+    history_columns_handler handler, const hash_digest& key,
+    uint32_t from_height, uint32_t timeout_milliseconds)
+{
+    static constexpr auto request = command::blockchain_fetch_history4;
+
+    auto data = build_chunk(
+    {
+        key,
+        to_little_endian<uint32_t>(from_height)
+    });
+
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
+}
+
+void obelisk_client::blockchain_fetch_history4_payments(
+    payment_handler handler, const hash_digest& key, uint32_t from_height,
+    uint32_t timeout_milliseconds)
+{
+    static constexpr auto request = command::blockchain_fetch_history4;
+
+    auto data = build_chunk(
+    {
+        key,
+        to_little_endian<uint32_t>(from_height)
+    });
+
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_unspent_outputs(
     points_value_handler handler, const hash_digest& key,
-    uint64_t satoshi, chain::points_value::selection algorithm)
+    uint64_t satoshi, chain::points_value::selection algorithm,
+    uint32_t timeout_milliseconds)
 {
     static constexpr uint32_t from_height = 0;
-    static const std::string command = "blockchain.fetch_history4";
+    static constexpr auto request = command::blockchain_fetch_history4;
 
-    const auto data = build_chunk(
+    auto data = build_chunk(
     {
         key,
         to_little_endian<uint32_t>(from_height)
     });
 
     auto select_from_history = [handler, satoshi, algorithm](
-        const code&, const history::list& rows)
+        const code& ec, const history::list& rows)
     {
+        // A failed (or timed out) query must not be reported as no unspent.
+        if (ec)
+        {
+            handler(ec, {});
+            return;
+        }
+
         chain::points_value unspent;
         unspent.points.reserve(rows.size());
 
@@ -1121,140 +2295,122 @@ void obelisk_client::blockchain_fetch_unspent_outputs(
         handler(error::success, selected);
     };
 
-    const auto id = ++last_request_index_;
-    history_handlers_[id] = select_from_history;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    submit(request, std::move(data), history_handler{ select_from_history },
+        timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_block_height(height_handler handler,
-    const hash_digest& block_hash)
+    const hash_digest& block_hash, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block_height";
-    const auto data = build_chunk({ block_hash });
-    const auto id = ++last_request_index_;
-    height_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block_height;
+    auto data = build_chunk({ block_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_block_transaction_hashes(
-    hash_list_handler handler, uint32_t height)
+    hash_list_handler handler, uint32_t height,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block_transaction_hashes";
-    const auto data = build_chunk({ to_little_endian<uint32_t>(height) });
-    const auto id = ++last_request_index_;
-    hash_list_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block_transaction_hashes;
+    auto data = build_chunk({ to_little_endian<uint32_t>(height) });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_block_transaction_hashes(
-    hash_list_handler handler, const hash_digest& block_hash)
+    hash_list_handler handler, const hash_digest& block_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_block_transaction_hashes";
-    const auto data = build_chunk({ block_hash });
-    const auto id = ++last_request_index_;
-    hash_list_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    static constexpr auto request = command::blockchain_fetch_block_transaction_hashes;
+    auto data = build_chunk({ block_hash });
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_compact_filter(
-    compact_filter_handler handler, uint8_t filter_type, uint32_t height)
+    compact_filter_handler handler, uint8_t filter_type, uint32_t height,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_compact_filter";
-    const auto data = build_chunk({
+    static constexpr auto request = command::blockchain_fetch_compact_filter;
+    auto data = build_chunk({
         to_array(filter_type),
         to_little_endian<uint32_t>(height)
     });
 
-    const auto id = ++last_request_index_;
-    compact_filter_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    const auto cacheable = buried(height);
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, cacheable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), cacheable, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_compact_filter(
     compact_filter_handler handler, uint8_t filter_type,
-    const system::hash_digest& block_hash)
+    const system::hash_digest& block_hash, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_compact_filter";
-    const auto data = build_chunk({
+    static constexpr auto request = command::blockchain_fetch_compact_filter;
+    auto data = build_chunk({
         to_array(filter_type),
         block_hash
     });
 
-    const auto id = ++last_request_index_;
-    compact_filter_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    auto key = request_key(request, data);
+    auto cached = find_cached(key, true);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds,
+        std::move(key), true, std::move(cached));
 }
 
 void obelisk_client::blockchain_fetch_compact_filter_headers(
     compact_filter_headers_handler handler, uint8_t filter_type,
-    uint32_t start_height, const system::hash_digest& stop_hash)
+    uint32_t start_height, const system::hash_digest& stop_hash,
+    uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_compact_filter_headers";
-    const auto data = build_chunk({
+    static constexpr auto request = command::blockchain_fetch_compact_filter_headers;
+    auto data = build_chunk({
         to_array(filter_type),
         to_little_endian<uint32_t>(start_height),
         stop_hash
     });
 
-    const auto id = ++last_request_index_;
-    compact_filter_headers_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_compact_filter_headers(
     compact_filter_headers_handler handler, uint8_t filter_type,
-    uint32_t start_height, uint32_t stop_height)
+    uint32_t start_height, uint32_t stop_height, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_compact_filter_headers";
-    const auto data = build_chunk({
+    static constexpr auto request = command::blockchain_fetch_compact_filter_headers;
+    auto data = build_chunk({
         to_array(filter_type),
         to_little_endian<uint32_t>(start_height),
         to_little_endian<uint32_t>(stop_height)
     });
 
-    const auto id = ++last_request_index_;
-    compact_filter_headers_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 void obelisk_client::blockchain_fetch_compact_filter_checkpoint(
     compact_filter_checkpoint_handler handler, uint8_t filter_type,
-    const system::hash_digest& stop_hash)
+    const system::hash_digest& stop_hash, uint32_t timeout_milliseconds)
 {
-    static const std::string command = "blockchain.fetch_compact_filter_checkpoint";
-    const auto data = build_chunk({
+    static constexpr auto request = command::blockchain_fetch_compact_filter_checkpoint;
+    auto data = build_chunk({
         to_array(filter_type),
         stop_hash
     });
 
-    const auto id = ++last_request_index_;
-    compact_filter_checkpoint_handlers_[id] = handler;
-    if (!send_request(command, id, data))
-        handle_immediate(command, id, error::network_unreachable);
+    submit(request, std::move(data), std::move(handler), timeout_milliseconds);
 }
 
 //void obelisk_client::blockchain_fetch_compact_filter_checkpoint(
 //    compact_filter_checkpoint_handler handler, uint8_t filter_type,
 //    uint32_t stop_height)
 //{
-//    static const std::string command = "blockchain.fetch_compact_filter_checkpoint";
-//    const auto data = build_chunk({
+//    static constexpr auto request = command::blockchain_fetch_compact_filter_checkpoint;
+//    auto data = build_chunk({
 //        to_array(filter_type),
 //        to_little_endian<uint32_t>(stop_height)
 //    });
 //
-//    const auto id = ++last_request_index_;
-//    compact_filter_checkpoint_handlers_[id] = handler;
-//    if (!send_request(command, id, data))
-//        handle_immediate(command, id, error::network_unreachable);
+//    submit(request, std::move(data), std::move(handler), 0);
 //}
 
 // Subscribers.
@@ -1264,7 +2420,7 @@ void obelisk_client::blockchain_fetch_compact_filter_checkpoint(
 uint32_t obelisk_client::subscribe_key(update_handler handler,
     const hash_digest& key)
 {
-    static const std::string command = "subscribe.key";
+    static constexpr auto request = command::subscribe_key;
     // [ key:32 ]
     const auto data = build_chunk({ key });
 
@@ -1276,9 +2432,9 @@ uint32_t obelisk_client::subscribe_key(update_handler handler,
     subscription_lock_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
-    if (!send_request(command, id, data, true))
+    if (!send_request(request, id, data, true))
     {
-        handle_immediate(command, id, error::network_unreachable);
+        handle_immediate(request, id, error::network_unreachable);
         return null_subscription;
     }
 
@@ -1290,7 +2446,7 @@ uint32_t obelisk_client::subscribe_key(update_handler handler,
 bool obelisk_client::unsubscribe_key(result_handler handler,
     uint32_t subscription)
 {
-    static const std::string command = "unsubscribe.key";
+    static constexpr auto request = command::unsubscribe_key;
 
     data_chunk data;
 
@@ -1311,9 +2467,9 @@ bool obelisk_client::unsubscribe_key(result_handler handler,
     subscription_lock_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
-    if (!send_request(command, id, data, true))
+    if (!send_request(request, id, data, true))
     {
-        handle_immediate(command, id, error::network_unreachable);
+        handle_immediate(request, id, error::network_unreachable);
         return false;
     }
 
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/response_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <bitcoin/system.hpp>
+
+using namespace bc::system;
+
+namespace libbitcoin {
+namespace client {
+
+// Approximates the list node, index node and bucket of an entry.
+static constexpr size_t entry_overhead = 128;
+
+// FNV-1a, as keys are short and hashes within them are uniform but heights
+// are not.
+size_t response_cache::key_hash::operator()(const key& request) const
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const auto byte: request)
+        hash = (hash ^ byte) * 0x100000001b3;
+
+    return static_cast<size_t>(hash);
+}
+
+// The number of shards of the budget, each of at least a minimum share.
+static size_t shard_count(size_t budget_bytes, size_t shards)
+{
+    return std::clamp<size_t>(budget_bytes / response_cache::minimum_share,
+        1, std::max<size_t>(shards, 1));
+}
+
+response_cache::response_cache(size_t budget_bytes, size_t shards)
+  : share_(budget_bytes / shard_count(budget_bytes, shards)),
+    shards_(shard_count(budget_bytes, shards)),
+    hits_(0),
+    misses_(0)
+{
+}
+
+response_cache::value response_cache::find(const key& request)
+{
+    auto& part = select(request);
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(part.mutex);
+
+    const auto it = part.index.find(request);
+    if (it == part.index.end())
+    {
+        lock.unlock();
+        ++misses_;
+        return {};
+    }
+
+    part.order.splice(part.order.begin(), part.order, it->second);
+    auto response = it->second->response;
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    ++hits_;
+    return response;
+}
+
+void response_cache::store(key&& request, const data_chunk& response)
+{
+    const auto cost = charge(request, response);
+    if (cost > share_)
+        return;
+
+    // The response is copied before the lock is taken.
+    auto cached = std::make_shared<const data_chunk>(response);
+    auto& part = select(request);
+
+    // Critical Section.
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(part.mutex);
+
+    const auto it = part.index.find(request);
+    if (it != part.index.end())
+    {
+        part.bytes -= charge(it->second->request, *it->second->response);
+        part.order.erase(it->second);
+        part.index.erase(it);
+    }
+
+    while (part.bytes + cost > share_)
+    {
+        const auto& last = part.order.back();
+        part.bytes -= charge(last.request, *last.response);
+        part.index.erase(last.request);
+        part.order.pop_back();
+    }
+
+    part.order.push_front({ request, std::move(cached) });
+    part.index.emplace(std::move(request), part.order.begin());
+    part.bytes += cost;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void response_cache::clear()
+{
+    for (auto& part: shards_)
+    {
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(part.mutex);
+        part.index.clear();
+        part.order.clear();
+        part.bytes = 0;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+size_t response_cache::hits() const
+{
+    return hits_;
+}
+
+size_t response_cache::misses() const
+{
+    return misses_;
+}
+
+size_t response_cache::size() const
+{
+    size_t count = 0;
+    for (auto& part: shards_)
+    {
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(part.mutex);
+        count += part.order.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return count;
+}
+
+size_t response_cache::bytes() const
+{
+    size_t total = 0;
+    for (auto& part: shards_)
+    {
+        // Critical Section.
+        ///////////////////////////////////////////////////////////////////////
+        std::lock_guard<std::mutex> lock(part.mutex);
+        total += part.bytes;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+size_t response_cache::shards() const
+{
+    return shards_.size();
+}
+
+// The key is held by both the list and the index.
+size_t response_cache::charge(const key& request, const data_chunk& data)
+{
+    return 2u * request.size() + data.size() + entry_overhead;
+}
+
+response_cache::shard& response_cache::select(const key& request)
+{
+    return shards_[key_hash()(request) % shards_.size()];
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,204 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/client/timer_wheel.hpp>
+
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace libbitcoin {
+namespace client {
+
+static constexpr uint64_t slot_mask = timer_wheel::slot_count - 1;
+
+// The tick shift of the span covered by one slot of the level.
+static constexpr size_t shift(size_t level)
+{
+    return level * timer_wheel::level_bits;
+}
+
+// The tick shift of the span covered by the whole level.
+static constexpr size_t span(size_t level)
+{
+    return shift(level + 1);
+}
+
+timer_wheel::timer_wheel(clock::time_point start)
+  : start_(start), current_(0), size_(0)
+{
+}
+
+uint64_t timer_wheel::to_tick(clock::time_point time, bool round_up) const
+{
+    if (time <= start_)
+        return 0;
+
+    const auto elapsed = time - start_;
+    return static_cast<uint64_t>(round_up ?
+        ceil<milliseconds>(elapsed).count() :
+        floor<milliseconds>(elapsed).count());
+}
+
+timer_wheel::clock::time_point timer_wheel::to_time(uint64_t tick) const
+{
+    return start_ + milliseconds(tick);
+}
+
+void timer_wheel::schedule(uint32_t id, command type,
+    clock::time_point deadline)
+{
+    insert({ id, type, to_tick(deadline, true) });
+    ++size_;
+}
+
+// A timer is placed in the lowest level whose span contains both the current
+// tick and its deadline, so that its slot is reached within the rotation.
+void timer_wheel::insert(const timer& entry)
+{
+    if (entry.tick <= current_)
+    {
+        due_.push_back(entry);
+        return;
+    }
+
+    for (size_t level = 0; level < level_count; ++level)
+    {
+        if ((entry.tick >> span(level)) == (current_ >> span(level)))
+        {
+            const auto slot = (entry.tick >> shift(level)) & slot_mask;
+            levels_[level][slot].push_back(entry);
+            return;
+        }
+    }
+
+    overflow_.push_back(entry);
+}
+
+// Reinsert the timers of a slot that has come into range of a lower level.
+void timer_wheel::cascade(timers& slot)
+{
+    timers moved;
+    std::swap(moved, slot);
+
+    for (const auto& entry: moved)
+        insert(entry);
+}
+
+// Move to the next tick, cascading from the highest level at its boundary.
+void timer_wheel::step(timers& expired)
+{
+    ++current_;
+
+    if ((current_ & ((uint64_t(1) << span(level_count - 1)) - 1)) == 0)
+        cascade(overflow_);
+
+    for (auto level = level_count - 1; level > 0; --level)
+        if ((current_ & ((uint64_t(1) << shift(level)) - 1)) == 0)
+            cascade(levels_[level][(current_ >> shift(level)) & slot_mask]);
+
+    // Timers due on a boundary tick are cascaded directly to the due list.
+    expire(due_, expired);
+    expire(levels_[0][current_ & slot_mask], expired);
+}
+
+void timer_wheel::expire(timers& slot, timers& expired)
+{
+    size_ -= slot.size();
+    expired.insert(expired.end(), slot.begin(), slot.end());
+    slot.clear();
+}
+
+void timer_wheel::advance(clock::time_point now, timers& expired)
+{
+    expire(due_, expired);
+
+    const auto target = to_tick(now, false);
+
+    // An empty wheel has nothing to cascade, so it may jump to the target,
+    // and otherwise ticks before the next that expires or cascades a timer
+    // are skipped, so that advancing after an idle period does not step
+    // through each elapsed tick.
+    while (current_ < target)
+    {
+        if (size_ == 0)
+        {
+            current_ = target;
+            break;
+        }
+
+        const auto next = std::min(next_tick(), target);
+        if (next > current_ + 1u)
+            current_ = next - 1u;
+
+        step(expired);
+    }
+}
+
+timer_wheel::clock::time_point timer_wheel::next_expiry() const
+{
+    if (size_ == 0)
+        return clock::time_point::max();
+
+    return to_time(next_tick());
+}
+
+// Level zero slots are exact, higher level slots give their cascade tick,
+// which precedes any deadline within them.
+uint64_t timer_wheel::next_tick() const
+{
+    if (!due_.empty())
+        return current_;
+
+    for (size_t level = 0; level < level_count; ++level)
+    {
+        const auto base = (current_ >> span(level)) << span(level);
+        const auto first = ((current_ >> shift(level)) & slot_mask) + 1;
+
+        for (auto slot = first; slot < slot_count; ++slot)
+            if (!levels_[level][slot].empty())
+                return base + (slot << shift(level));
+    }
+
+    const auto top = span(level_count - 1);
+    return ((current_ >> top) + 1) << top;
+}
+
+void timer_wheel::clear()
+{
+    for (auto& level: levels_)
+        for (auto& slot: level)
+            slot.clear();
+
+    due_.clear();
+    overflow_.clear();
+    size_ = 0;
+}
+
+size_t timer_wheel::size() const
+{
+    return size_;
+}
+
+bool timer_wheel::empty() const
+{
+    return size_ == 0;
+}
+
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(adaptive_limit_tests)
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__construct__initial)
+{
+    const adaptive_limit limit(10, 1, 100);
+    BOOST_REQUIRE_EQUAL(limit.limit(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__construct__initial_bounded)
+{
+    BOOST_REQUIRE_EQUAL(adaptive_limit(0, 2, 100).limit(), 2u);
+    BOOST_REQUIRE_EQUAL(adaptive_limit(500, 2, 100).limit(), 100u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__construct__zero_bounds__one)
+{
+    BOOST_REQUIRE_EQUAL(adaptive_limit(0, 0, 0).limit(), 1u);
+    BOOST_REQUIRE_EQUAL(adaptive_limit(10, 0, 0).limit(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__sample__steady_at_limit__widens_to_maximum)
+{
+    adaptive_limit limit(10, 1, 100);
+
+    for (auto sample = 0; sample < 1000; ++sample)
+        limit.sample(milliseconds(10), limit.limit());
+
+    BOOST_REQUIRE_EQUAL(limit.limit(), 100u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__sample__application_limited__unchanged)
+{
+    adaptive_limit limit(10, 1, 100);
+
+    for (auto sample = 0; sample < 100; ++sample)
+        limit.sample(milliseconds(10), 1);
+
+    BOOST_REQUIRE_EQUAL(limit.limit(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__sample__queueing__narrows)
+{
+    adaptive_limit limit(50, 1, 100);
+    limit.sample(milliseconds(10), 50);
+    const auto unloaded = limit.limit();
+
+    for (auto sample = 0; sample < 50; ++sample)
+        limit.sample(milliseconds(100), limit.limit());
+
+    BOOST_REQUIRE_LT(limit.limit(), unloaded / 4);
+    BOOST_REQUIRE_GE(limit.limit(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__sample__latency_within_tolerance__widens)
+{
+    adaptive_limit limit(10, 1, 100);
+    limit.sample(milliseconds(10), 10);
+    const auto unloaded = limit.limit();
+
+    for (auto sample = 0; sample < 10; ++sample)
+        limit.sample(milliseconds(15), limit.limit());
+
+    BOOST_REQUIRE_GT(limit.limit(), unloaded);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__sample__baseline_rises__recovers)
+{
+    adaptive_limit limit(20, 1, 100);
+    limit.sample(milliseconds(1), 20);
+
+    // A sustained rise in latency becomes the new baseline.
+    for (auto sample = 0; sample < 200; ++sample)
+        limit.sample(milliseconds(50), limit.limit());
+
+    const auto settled = limit.limit();
+    for (auto sample = 0; sample < 50; ++sample)
+        limit.sample(milliseconds(50), limit.limit());
+
+    BOOST_REQUIRE_GT(limit.limit(), settled);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_limit__drop__backs_off_to_minimum)
+{
+    adaptive_limit limit(100, 5, 100);
+    limit.drop();
+    BOOST_REQUIRE_EQUAL(limit.limit(), 90u);
+
+    for (auto drop = 0; drop < 100; ++drop)
+        limit.drop();
+
+    BOOST_REQUIRE_EQUAL(limit.limit(), 5u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
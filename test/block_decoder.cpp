@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// Deliver until the count of blocks is delivered or five seconds have passed.
+static size_t deliver_all(block_decoder& decoder, size_t count,
+    const block_decoder::block_handler& handler)
+{
+    const auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::seconds(5);
+
+    size_t delivered = 0;
+    while (delivered < count && std::chrono::steady_clock::now() < deadline)
+    {
+        delivered += decoder.deliver(handler);
+        std::this_thread::yield();
+    }
+
+    return delivered;
+}
+
+BOOST_AUTO_TEST_SUITE(block_decoder_tests)
+
+BOOST_AUTO_TEST_CASE(block_decoder__deliver__empty__none)
+{
+    block_decoder decoder(2, {});
+    BOOST_REQUIRE_EQUAL(decoder.pending(), 0u);
+    BOOST_REQUIRE_EQUAL(decoder.deliver([](const block&)
+    {
+        BOOST_FAIL("unexpected block");
+    }), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(block_decoder__deliver__varying_sizes__push_order)
+{
+    static constexpr size_t blocks = 32;
+    std::atomic<size_t> notified(0);
+    block_decoder decoder(4, [&notified]() { ++notified; });
+
+    // Large blocks are interleaved with small, so parsing completes out of
+    // order, and the transaction count identifies the block.
+    for (size_t index = 0; index < blocks; ++index)
+        decoder.push(mock::block_data(index % 2 ? index + 1 : 100 * (index + 1)));
+
+    std::vector<size_t> counts;
+    const auto delivered = deliver_all(decoder, blocks,
+        [&counts](const block& block)
+        {
+            counts.push_back(block.transactions().size());
+        });
+
+    BOOST_REQUIRE_EQUAL(delivered, blocks);
+    BOOST_REQUIRE_EQUAL(decoder.pending(), 0u);
+    BOOST_REQUIRE_EQUAL(notified, blocks);
+
+    for (size_t index = 0; index < blocks; ++index)
+        BOOST_REQUIRE_EQUAL(counts[index],
+            index % 2 ? index + 1 : 100 * (index + 1));
+}
+
+BOOST_AUTO_TEST_CASE(block_decoder__deliver__invalid__delivered_in_order)
+{
+    block_decoder decoder(2, {});
+    decoder.push(mock::block_data(1));
+    decoder.push(data_chunk{ 0x00 });
+    decoder.push(mock::block_data(3));
+
+    std::vector<bool> valid;
+    const auto delivered = deliver_all(decoder, 3, [&valid](const block& block)
+    {
+        valid.push_back(block.is_valid());
+    });
+
+    BOOST_REQUIRE_EQUAL(delivered, 3u);
+    BOOST_REQUIRE(valid[0]);
+    BOOST_REQUIRE(!valid[1]);
+    BOOST_REQUIRE(valid[2]);
+}
+
+BOOST_AUTO_TEST_CASE(block_decoder__destruct__pending__joins)
+{
+    {
+        block_decoder decoder(1, {});
+        for (size_t index = 0; index < 16; ++index)
+            decoder.push(mock::block_data(1000));
+
+        BOOST_REQUIRE(decoder.pending() > 0u);
+    }
+
+    BOOST_REQUIRE(true);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
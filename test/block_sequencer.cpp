@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace bc::system;
+
+// Blocks are identified by a single byte of their height.
+static data_chunk block_at(size_t height)
+{
+    return { static_cast<uint8_t>(height) };
+}
+
+// Records fetches and deliveries, so that fetches may be answered later.
+struct sequencer_fixture
+{
+    sequencer_fixture(size_t window=8, size_t retries=2)
+      : sequencer(
+            [this](size_t height) { fetches.push_back(height); },
+            [this](size_t height, data_chunk&& data)
+            {
+                BOOST_REQUIRE(data == block_at(height));
+                delivered.push_back(height);
+            }, window,
+            [this](size_t height) { failed.push_back(height); }, retries)
+    {
+    }
+
+    // Retries are due once their delay has passed.
+    void retry_due()
+    {
+        sequencer.retry(block_sequencer::clock::now() + std::chrono::hours(1));
+    }
+
+    std::vector<size_t> fetches;
+    std::vector<size_t> delivered;
+    std::vector<size_t> failed;
+    block_sequencer sequencer;
+};
+
+BOOST_AUTO_TEST_SUITE(block_sequencer_tests)
+
+BOOST_AUTO_TEST_CASE(block_sequencer__live__untracked__delivered_and_tracked)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.live(42, block_at(42));
+
+    BOOST_REQUIRE(fixture.sequencer.tracking());
+    BOOST_REQUIRE_EQUAL(fixture.sequencer.last_height(), 42u);
+    BOOST_REQUIRE(fixture.delivered == std::vector<size_t>{ 42 });
+    BOOST_REQUIRE(fixture.fetches.empty());
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__live__consecutive__delivered_without_fetch)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.track(9);
+    fixture.sequencer.live(10, block_at(10));
+    fixture.sequencer.live(11, block_at(11));
+
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 10, 11 }));
+    BOOST_REQUIRE(fixture.fetches.empty());
+    BOOST_REQUIRE(!fixture.sequencer.backfilling());
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__live__gap__fetches_missing_and_holds)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.track(10);
+    fixture.sequencer.live(14, block_at(14));
+
+    BOOST_REQUIRE(fixture.sequencer.backfilling());
+    BOOST_REQUIRE(fixture.delivered.empty());
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 12, 13 }));
+
+    // Out of order answers are delivered in height order, then the held.
+    fixture.sequencer.fetched(13, block_at(13));
+    fixture.sequencer.fetched(11, block_at(11));
+    BOOST_REQUIRE(fixture.delivered == std::vector<size_t>{ 11 });
+
+    fixture.sequencer.fetched(12, block_at(12));
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 11, 12, 13, 14 }));
+    BOOST_REQUIRE(!fixture.sequencer.backfilling());
+    BOOST_REQUIRE_EQUAL(fixture.sequencer.last_height(), 14u);
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__live__during_backfill__held_in_order)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.track(10);
+    fixture.sequencer.live(12, block_at(12));
+    fixture.sequencer.live(13, block_at(13));
+    fixture.sequencer.live(15, block_at(15));
+
+    BOOST_REQUIRE(fixture.fetches == std::vector<size_t>{ 11 });
+
+    // The gap between held blocks is fetched as they are released.
+    fixture.sequencer.fetched(11, block_at(11));
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 11, 12, 13 }));
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 14 }));
+
+    fixture.sequencer.fetched(14, block_at(14));
+    BOOST_REQUIRE(fixture.delivered ==
+        (std::vector<size_t>{ 11, 12, 13, 14, 15 }));
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__fetched__window__limits_undelivered)
+{
+    sequencer_fixture fixture(2);
+    fixture.sequencer.track(0);
+    fixture.sequencer.backfill(5);
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 1, 2 }));
+
+    // A block above a slow height is buffered, and opens no space.
+    fixture.sequencer.fetched(2, block_at(2));
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 1, 2 }));
+
+    fixture.sequencer.fetched(1, block_at(1));
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 1, 2, 3, 4 }));
+
+    fixture.sequencer.fetched(3, block_at(3));
+    fixture.sequencer.fetched(4, block_at(4));
+    fixture.sequencer.fetched(5, block_at(5));
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 1, 2, 3, 4, 5 }));
+    BOOST_REQUIRE(!fixture.sequencer.backfilling());
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__fetched__failure__height_fetched_again_after_delay)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.track(10);
+    fixture.sequencer.live(13, block_at(13));
+
+    fixture.sequencer.fetched(11, {});
+    fixture.sequencer.fetched(12, block_at(12));
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 12 }));
+    BOOST_REQUIRE(fixture.sequencer.next_retry() >
+        block_sequencer::clock::now());
+
+    // Not yet due.
+    fixture.sequencer.retry();
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 12 }));
+
+    fixture.retry_due();
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 12, 11 }));
+    BOOST_REQUIRE(fixture.delivered.empty());
+    BOOST_REQUIRE(fixture.failed.empty());
+    BOOST_REQUIRE(fixture.sequencer.backfilling());
+
+    fixture.sequencer.fetched(11, block_at(11));
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 11, 12, 13 }));
+    BOOST_REQUIRE_EQUAL(fixture.sequencer.last_height(), 13u);
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__fetched__failures_exceed_retries__reported_and_fetched_on_feed_block)
+{
+    sequencer_fixture fixture(8, 2);
+    fixture.sequencer.track(10);
+    fixture.sequencer.live(12, block_at(12));
+
+    // The first fetch and both retries fail.
+    for (auto attempt = 0; attempt < 3; ++attempt)
+    {
+        fixture.sequencer.fetched(11, {});
+        fixture.retry_due();
+    }
+
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 11, 11 }));
+    BOOST_REQUIRE(fixture.failed == std::vector<size_t>{ 11 });
+    BOOST_REQUIRE(fixture.sequencer.next_retry() ==
+        block_sequencer::clock::time_point::max());
+    BOOST_REQUIRE(fixture.sequencer.backfilling());
+
+    // The next feed block fetches the height again.
+    fixture.sequencer.live(13, block_at(13));
+    BOOST_REQUIRE(fixture.fetches == (std::vector<size_t>{ 11, 11, 11, 11 }));
+
+    fixture.sequencer.fetched(11, block_at(11));
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 11, 12, 13 }));
+    BOOST_REQUIRE(!fixture.sequencer.backfilling());
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__backfill__untracked__no_fetch)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.backfill(5);
+    BOOST_REQUIRE(fixture.fetches.empty());
+    BOOST_REQUIRE(!fixture.sequencer.backfilling());
+}
+
+BOOST_AUTO_TEST_CASE(block_sequencer__live__lower_height__delivered_as_reorganization)
+{
+    sequencer_fixture fixture;
+    fixture.sequencer.track(10);
+    fixture.sequencer.live(9, block_at(9));
+    fixture.sequencer.live(10, block_at(10));
+
+    BOOST_REQUIRE(fixture.delivered == (std::vector<size_t>{ 9, 10 }));
+    BOOST_REQUIRE(fixture.fetches.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
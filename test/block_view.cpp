@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// A header, one transaction count, and one witness transaction.
+static data_chunk witness_block()
+{
+    auto data = mock::block_data(0, 7);
+    data.pop_back();
+    data.push_back(1);
+
+    const data_chunk transaction
+    {
+        // version
+        0x01, 0x00, 0x00, 0x00,
+
+        // marker and flag
+        0x00, 0x01,
+
+        // one input, with an empty script
+        0x01,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+        0x00, 0x00, 0x00, 0x00,
+        0x00,
+        0xff, 0xff, 0xff, 0xff,
+
+        // one output, with a one byte script
+        0x01,
+        0xe8, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x01, 0x51,
+
+        // two witness elements
+        0x02,
+        0x02, 0xbb, 0xbb,
+        0x00,
+
+        // locktime
+        0x00, 0x00, 0x00, 0x00
+    };
+
+    data.insert(data.end(), transaction.begin(), transaction.end());
+    return data;
+}
+
+BOOST_AUTO_TEST_SUITE(block_view_tests)
+
+BOOST_AUTO_TEST_CASE(block_view__construct__default__invalid)
+{
+    const block_view view;
+    BOOST_REQUIRE(!view.is_valid());
+    BOOST_REQUIRE_EQUAL(view.size(), 0u);
+    BOOST_REQUIRE(view.begin() == view.end());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__construct__short_header__invalid)
+{
+    const block_view view(data_chunk(79, 0x00));
+    BOOST_REQUIRE(!view.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__construct__corrupt_count__invalid)
+{
+    auto data = mock::block_data(0);
+    data.pop_back();
+    data.push_back(0xfe);
+    data.insert(data.end(), { 0xff, 0xff, 0xff, 0xff });
+
+    const block_view view(std::move(data));
+    BOOST_REQUIRE(!view.is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__header__block__expected)
+{
+    auto data = mock::block_data(10, 42);
+    block block;
+    BOOST_REQUIRE(block.from_data(data));
+
+    const block_view view(std::move(data));
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE_EQUAL(view.size(), 10u);
+    BOOST_REQUIRE(view.header().hash() == block.header().hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transaction__each__matches_block)
+{
+    auto data = mock::block_data(10, 42);
+    block block;
+    BOOST_REQUIRE(block.from_data(data));
+
+    const block_view view(std::move(data));
+    const auto& transactions = block.transactions();
+
+    // Out of order access locates the preceding transactions once.
+    BOOST_REQUIRE(view.transaction(7).hash() == transactions[7].hash());
+
+    for (size_t index = 0; index < transactions.size(); ++index)
+        BOOST_REQUIRE(view.transaction(index).hash() ==
+            transactions[index].hash());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__iterate__all__matches_block)
+{
+    auto data = mock::block_data(5);
+    block block;
+    BOOST_REQUIRE(block.from_data(data));
+
+    const block_view view(std::move(data));
+    size_t index = 0;
+
+    for (const auto& transaction: view)
+        BOOST_REQUIRE(transaction.hash() ==
+            block.transactions()[index++].hash());
+
+    BOOST_REQUIRE_EQUAL(index, 5u);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transaction__out_of_range__invalid)
+{
+    const block_view view(mock::block_data(3));
+    BOOST_REQUIRE(!view.transaction(3).is_valid());
+    BOOST_REQUIRE(view.transaction_data(3).empty());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transaction__truncated__invalid)
+{
+    auto data = mock::block_data(3);
+    data.resize(data.size() - 1);
+
+    const block_view view(std::move(data));
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE(view.transaction(1).is_valid());
+    BOOST_REQUIRE(!view.transaction(2).is_valid());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__transaction_data__witness__whole_transaction)
+{
+    auto data = witness_block();
+    const auto size = data.size() - header::satoshi_fixed_size() - 1u;
+
+    const block_view view(std::move(data), true);
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE_EQUAL(view.size(), 1u);
+    BOOST_REQUIRE_EQUAL(view.transaction_data(0).size(), size);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__to_block__block__equal)
+{
+    auto data = mock::block_data(4);
+    block block;
+    BOOST_REQUIRE(block.from_data(data));
+
+    const block_view view(std::move(data));
+    BOOST_REQUIRE(view.to_block().hash() == block.hash());
+    BOOST_REQUIRE_EQUAL(view.to_block().transactions().size(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(block_view__construct__shared_payload__block_not_copied)
+{
+    const auto data = mock::block_data(5, 42);
+    block block;
+    BOOST_REQUIRE(block.from_data(data));
+
+    const auto payload = std::make_shared<const data_chunk>(
+        mock::block_payload(5, 42));
+
+    const block_view view(payload, sizeof(uint32_t));
+    BOOST_REQUIRE(view.is_valid());
+    BOOST_REQUIRE(view.data().data() == payload->data() + sizeof(uint32_t));
+    BOOST_REQUIRE_EQUAL(view.data().size(), data.size());
+    BOOST_REQUIRE(view.header().hash() == block.header().hash());
+    BOOST_REQUIRE(view.transaction(4).hash() ==
+        block.transactions()[4].hash());
+
+    // Copies share the buffer.
+    const auto copy = view;
+    BOOST_REQUIRE(copy.data().data() == view.data().data());
+}
+
+BOOST_AUTO_TEST_CASE(block_view__construct__offset_past_buffer__invalid)
+{
+    const auto payload = std::make_shared<const data_chunk>(
+        mock::block_payload(1));
+
+    const block_view view(payload, payload->size() + 1u);
+    BOOST_REQUIRE(!view.is_valid());
+    BOOST_REQUIRE(view.data().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
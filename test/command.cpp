@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <string>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace bc::system;
+
+BOOST_AUTO_TEST_SUITE(command_tests)
+
+BOOST_AUTO_TEST_CASE(command__to_command__all_frames__round_trip)
+{
+    for (size_t index = 0; index < command_count; ++index)
+    {
+        const auto type = static_cast<command>(index);
+        BOOST_REQUIRE(!command_name(type).empty());
+        BOOST_REQUIRE(to_command(command_frame(type)) == type);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(command__command_frame__server_version__expected)
+{
+    const auto& frame = command_frame(command::server_version);
+    BOOST_REQUIRE_EQUAL(std::string(frame.begin(), frame.end()),
+        "server.version");
+}
+
+BOOST_AUTO_TEST_CASE(command__to_command__empty__unknown)
+{
+    BOOST_REQUIRE(to_command(data_chunk{}) == command::unknown);
+}
+
+BOOST_AUTO_TEST_CASE(command__to_command__prefix__unknown)
+{
+    BOOST_REQUIRE(to_command(to_chunk(std::string("blockchain.fetch_block_"))) ==
+        command::unknown);
+}
+
+BOOST_AUTO_TEST_CASE(command__to_command__longer_name__matches_exactly)
+{
+    BOOST_REQUIRE(to_command(to_chunk(std::string(
+        "blockchain.fetch_transaction2"))) ==
+        command::blockchain_fetch_transaction2);
+}
+
+BOOST_AUTO_TEST_CASE(command__command_name__unknown__empty)
+{
+    BOOST_REQUIRE(command_name(command::unknown).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
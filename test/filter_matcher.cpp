@@ -0,0 +1,257 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+
+// Writes bits most significant first.
+struct bit_writer
+{
+    void write(uint64_t value, size_t count)
+    {
+        for (auto bit = count; bit > 0u; --bit)
+        {
+            if (used % 8u == 0u)
+                data.push_back(0);
+
+            if (((value >> (bit - 1u)) & 1u) != 0u)
+                data.back() |= static_cast<uint8_t>(0x80u >> (used % 8u));
+
+            ++used;
+        }
+    }
+
+    data_chunk data;
+    size_t used = 0;
+};
+
+// The high word of the product, computed a bit at a time.
+static uint64_t multiply_high(uint64_t left, uint64_t right)
+{
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (auto bit = 0u; bit < 64u; ++bit)
+    {
+        if (((right >> bit) & 1u) == 0u)
+            continue;
+
+        const auto addend_low = left << bit;
+        const auto addend_high = bit == 0u ? 0u : left >> (64u - bit);
+        low += addend_low;
+        high += addend_high + (low < addend_low ? 1u : 0u);
+    }
+
+    return high;
+}
+
+// A basic filter of the items under the block hash (BIP158).
+static data_chunk encode_filter(const hash_digest& block_hash,
+    const data_stack& items)
+{
+    const auto range = items.size() * filter_matcher::golomb_rate;
+    std::vector<uint64_t> values;
+    for (const auto& item: items)
+        values.push_back(multiply_high(filter_matcher::siphash(block_hash,
+            item), range));
+
+    std::sort(values.begin(), values.end());
+
+    bit_writer writer;
+    uint64_t previous = 0;
+    for (const auto value: values)
+    {
+        const auto delta = value - previous;
+        for (auto quotient = delta >> filter_matcher::golomb_bits;
+            quotient > 0u; --quotient)
+            writer.write(1, 1);
+
+        writer.write(0, 1);
+        writer.write(delta, filter_matcher::golomb_bits);
+        previous = value;
+    }
+
+    // Item counts of the tests are less than 0xfd.
+    return build_chunk(
+    {
+        to_array(static_cast<uint8_t>(items.size())),
+        writer.data
+    });
+}
+
+// Scripts distinct for each index and set.
+static data_stack make_items(size_t count, uint8_t set)
+{
+    data_stack items;
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto bytes = to_little_endian(static_cast<uint32_t>(index));
+        items.push_back({ 0x00, 0x14, set, bytes[0], bytes[1], bytes[2],
+            bytes[3] });
+    }
+
+    return items;
+}
+
+BOOST_AUTO_TEST_SUITE(filter_matcher_tests)
+
+// Test vectors from the SipHash paper, keyed by bytes 0x00 through 0x0f.
+BOOST_AUTO_TEST_CASE(filter_matcher__siphash__reference_vectors__expected)
+{
+    auto key = null_hash;
+    for (size_t byte = 0; byte < key.size(); ++byte)
+        key[byte] = static_cast<uint8_t>(byte);
+
+    data_chunk message;
+    BOOST_REQUIRE_EQUAL(filter_matcher::siphash(key, message),
+        0x726fdb47dd0e0e31u);
+
+    for (uint8_t byte = 0; byte < 15u; ++byte)
+        message.push_back(byte);
+
+    BOOST_REQUIRE_EQUAL(filter_matcher::siphash(key, message),
+        0xa129ca6149be45e5u);
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__item_in_filter__true)
+{
+    const auto hash = block_hash_at(42);
+    const auto block_items = make_items(100, 1);
+    const auto filter = encode_filter(hash, block_items);
+
+    for (const auto& item: block_items)
+    {
+        const filter_matcher matcher({ make_items(1, 2).front(), item });
+        BOOST_REQUIRE(matcher.match(hash, filter));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__items_not_in_filter__false)
+{
+    const auto hash = block_hash_at(42);
+    const auto filter = encode_filter(hash, make_items(100, 1));
+    const filter_matcher matcher(make_items(1000, 2));
+
+    BOOST_REQUIRE_EQUAL(matcher.size(), 1000u);
+    BOOST_REQUIRE(!matcher.match(hash, filter));
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__many_items_one_in_filter__true)
+{
+    const auto hash = block_hash_at(42);
+    const auto block_items = make_items(100, 1);
+    const auto filter = encode_filter(hash, block_items);
+
+    auto items = make_items(1000, 2);
+    items.push_back(block_items[37]);
+    const filter_matcher matcher(items);
+
+    BOOST_REQUIRE(matcher.match(hash, filter));
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__other_block_key__false)
+{
+    const auto block_items = make_items(100, 1);
+    const auto filter = encode_filter(block_hash_at(42), block_items);
+    const filter_matcher matcher({ block_items[7] });
+
+    BOOST_REQUIRE(!matcher.match(block_hash_at(43), filter));
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__empty_or_truncated__false)
+{
+    const auto hash = block_hash_at(42);
+    const auto block_items = make_items(100, 1);
+    auto filter = encode_filter(hash, block_items);
+    const filter_matcher matcher({ block_items.back() });
+
+    BOOST_REQUIRE(!matcher.match(hash, data_chunk{}));
+    BOOST_REQUIRE(!matcher.match(hash, data_chunk{ 0x00 }));
+
+    filter.resize(filter.size() / 2u);
+    BOOST_REQUIRE(!matcher.match(hash, filter));
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__filters_in_parallel__matching_indexes)
+{
+    const auto wallet = make_items(50, 2);
+    std::vector<message::compact_filter> filters;
+    std::vector<size_t> expected;
+
+    // Every seventh block pays one of the wallet's scripts.
+    for (size_t height = 0; height < 1000u; ++height)
+    {
+        auto block_items = make_items(20, 1);
+        if (height % 7u == 0u)
+        {
+            block_items.push_back(wallet[height % wallet.size()]);
+            expected.push_back(height);
+        }
+
+        const auto hash = block_hash_at(height);
+        filters.emplace_back(0, hash, encode_filter(hash, block_items));
+    }
+
+    const filter_matcher matcher(wallet);
+    BOOST_REQUIRE(matcher.match(filters, 4) == expected);
+    BOOST_REQUIRE(matcher.match(filters, 1) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(filter_matcher__match__store_range__matching_heights)
+{
+    const auto directory = temporary_path("libbitcoin_client_filter_matcher");
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    const auto wallet = make_items(10, 2);
+    {
+        filter_store store(directory, 0);
+        BOOST_REQUIRE(store.open());
+
+        for (size_t height = 0; height < 300u; ++height)
+        {
+            auto block_items = make_items(20, 1);
+            if (height == 5u || height == 150u || height == 299u)
+                block_items.push_back(wallet[3]);
+
+            const auto hash = block_hash_at(height);
+            BOOST_REQUIRE(store.push(hash, encode_filter(hash, block_items)));
+        }
+
+        const filter_matcher matcher(wallet);
+        BOOST_REQUIRE(matcher.match(store, 0, 299, 3) ==
+            (std::vector<size_t>{ 5, 150, 299 }));
+        BOOST_REQUIRE(matcher.match(store, 6, 1000, 3) ==
+            (std::vector<size_t>{ 150, 299 }));
+        BOOST_REQUIRE(matcher.match(store, 300, 400).empty());
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
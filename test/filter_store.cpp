@@ -0,0 +1,263 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+
+// A directory in the temporary directory, removed on construction and
+// destruction.
+struct store_fixture
+{
+    store_fixture()
+      : directory(temporary_path("libbitcoin_client_filter_store"))
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+
+    ~store_fixture()
+    {
+        std::filesystem::remove_all(directory);
+    }
+
+    bool fill(filter_store& store, size_t count)
+    {
+        for (size_t height = 0; height < count; ++height)
+            if (!store.push(block_hash_at(height), filter_at(height)))
+                return false;
+
+        return true;
+    }
+
+    const std::filesystem::path directory;
+};
+
+BOOST_FIXTURE_TEST_SUITE(filter_store_tests, store_fixture)
+
+BOOST_AUTO_TEST_CASE(filter_store__open__new__empty)
+{
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(store.empty());
+    BOOST_REQUIRE_EQUAL(store.size(), 0u);
+    BOOST_REQUIRE(store.top_header() == null_hash);
+
+    data_chunk out;
+    BOOST_REQUIRE(!store.get(out, 0));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__push__chain__lookups_by_height_and_hash)
+{
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(fill(store, 3000));
+    BOOST_REQUIRE_EQUAL(store.size(), 3000u);
+
+    for (size_t height = 0; height < 3000u; ++height)
+    {
+        data_chunk filter;
+        BOOST_REQUIRE(store.get(filter, height));
+        BOOST_REQUIRE(filter == filter_at(height));
+
+        hash_digest hash;
+        BOOST_REQUIRE(store.block_hash(hash, height));
+        BOOST_REQUIRE(hash == block_hash_at(height));
+
+        size_t found;
+        BOOST_REQUIRE(store.get(found, block_hash_at(height)));
+        BOOST_REQUIRE_EQUAL(found, height);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__push__chain__filter_headers_chained)
+{
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(fill(store, 3));
+
+    auto previous = null_hash;
+    for (size_t height = 0; height < 3u; ++height)
+    {
+        const auto expected = bitcoin_hash(build_chunk(
+        {
+            bitcoin_hash(filter_at(height)),
+            previous
+        }));
+
+        hash_digest header;
+        BOOST_REQUIRE(store.filter_header(header, height));
+        BOOST_REQUIRE(header == expected);
+        previous = header;
+    }
+
+    BOOST_REQUIRE(store.top_header() == previous);
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__get__message__type_hash_and_filter)
+{
+    filter_store store(directory, 1);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(fill(store, 5));
+
+    message::compact_filter out;
+    BOOST_REQUIRE(store.get(out, 4));
+    BOOST_REQUIRE_EQUAL(out.filter_type(), 1u);
+    BOOST_REQUIRE(out.block_hash() == block_hash_at(4));
+    BOOST_REQUIRE(out.filter() == filter_at(4));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__open__reopened__persisted_and_indexed)
+{
+    {
+        filter_store store(directory, 0);
+        BOOST_REQUIRE(store.open());
+        BOOST_REQUIRE(fill(store, 10));
+        BOOST_REQUIRE(store.close());
+    }
+
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE_EQUAL(store.size(), 10u);
+
+    size_t height;
+    BOOST_REQUIRE(store.get(height, block_hash_at(7)));
+    BOOST_REQUIRE_EQUAL(height, 7u);
+
+    data_chunk filter;
+    BOOST_REQUIRE(store.get(filter, 9));
+    BOOST_REQUIRE(filter == filter_at(9));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__open__filter_types__separate)
+{
+    filter_store basic(directory, 0);
+    filter_store other(directory, 1);
+    BOOST_REQUIRE(basic.open());
+    BOOST_REQUIRE(other.open());
+    BOOST_REQUIRE(fill(basic, 4));
+
+    BOOST_REQUIRE_EQUAL(basic.size(), 4u);
+    BOOST_REQUIRE(other.empty());
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__open__data_short__unwritten_filters_dropped)
+{
+    {
+        filter_store store(directory, 0);
+        BOOST_REQUIRE(store.open());
+        BOOST_REQUIRE(fill(store, 3));
+        BOOST_REQUIRE(store.close());
+    }
+
+    // The data of the last filter did not reach the disk.
+    const auto written = filter_at(0).size() + filter_at(1).size();
+    std::filesystem::resize_file(directory / "filters_0.data", written);
+
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE_EQUAL(store.size(), 2u);
+
+    size_t height;
+    BOOST_REQUIRE(!store.get(height, block_hash_at(2)));
+    BOOST_REQUIRE(store.push(block_hash_at(2), filter_at(2)));
+
+    data_chunk filter;
+    BOOST_REQUIRE(store.get(filter, 2));
+    BOOST_REQUIRE(filter == filter_at(2));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__open__data_uncommitted__unflushed_filters_dropped)
+{
+    const auto crashed = directory / "crashed";
+    std::filesystem::create_directories(crashed);
+    size_t committed = 0;
+
+    {
+        filter_store store(directory, 0);
+        BOOST_REQUIRE(store.open());
+        BOOST_REQUIRE(fill(store, 3));
+        BOOST_REQUIRE(store.flush());
+        for (size_t height = 0; height < 3u; ++height)
+            committed += filter_at(height).size();
+
+        BOOST_REQUIRE(store.push(block_hash_at(3), filter_at(3)));
+        BOOST_REQUIRE(store.push(block_hash_at(4), filter_at(4)));
+
+        // The index reached the disk, but the unflushed data did not.
+        for (const auto extension: { ".index", ".data" })
+            std::filesystem::copy_file(directory / ("filters_0" +
+                std::string(extension)), crashed / ("filters_0" +
+                std::string(extension)));
+    }
+
+    // The data file keeps its size, as it is grown ahead of its data.
+    const auto data = crashed / "filters_0.data";
+    const auto reserved = std::filesystem::file_size(data);
+    std::filesystem::resize_file(data, committed);
+    std::filesystem::resize_file(data, reserved);
+
+    filter_store store(crashed, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE_EQUAL(store.size(), 3u);
+
+    size_t height;
+    BOOST_REQUIRE(!store.get(height, block_hash_at(3)));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__truncate__top__dropped_and_replaced)
+{
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(fill(store, 10));
+
+    hash_digest header;
+    BOOST_REQUIRE(store.filter_header(header, 7));
+    BOOST_REQUIRE(store.truncate(8));
+    BOOST_REQUIRE_EQUAL(store.size(), 8u);
+    BOOST_REQUIRE(store.top_header() == header);
+
+    size_t height;
+    BOOST_REQUIRE(!store.get(height, block_hash_at(8)));
+
+    // A competing filter replaces the dropped height.
+    BOOST_REQUIRE(store.push(block_hash_at(8, 1), filter_at(8, 1)));
+    BOOST_REQUIRE(store.get(height, block_hash_at(8, 1)));
+    BOOST_REQUIRE_EQUAL(height, 8u);
+
+    data_chunk filter;
+    BOOST_REQUIRE(store.get(filter, 8));
+    BOOST_REQUIRE(filter == filter_at(8, 1));
+}
+
+BOOST_AUTO_TEST_CASE(filter_store__push__closed__false)
+{
+    filter_store store(directory, 0);
+    BOOST_REQUIRE(!store.push(block_hash_at(0), filter_at(0)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
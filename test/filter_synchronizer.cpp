@@ -0,0 +1,277 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/obelisk_server.hpp"
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+
+// A block and its filter.
+struct block_filter
+{
+    hash_digest block_hash;
+    data_chunk filter;
+};
+
+// A chain of filters of blocks distinct in their first bytes for each salt.
+static std::vector<block_filter> make_chain(size_t count, uint8_t salt=0)
+{
+    std::vector<block_filter> chain;
+    for (size_t height = 0; height < count; ++height)
+        chain.push_back({ block_hash_at(height, salt),
+            filter_at(height, salt) });
+
+    return chain;
+}
+
+// The filter header at each height of the chain (BIP157).
+static hash_list filter_headers(const std::vector<block_filter>& chain)
+{
+    hash_list headers;
+    auto previous = null_hash;
+    for (const auto& block: chain)
+    {
+        previous = bitcoin_hash(build_chunk(
+        {
+            bitcoin_hash(block.filter),
+            previous
+        }));
+
+        headers.push_back(previous);
+    }
+
+    return headers;
+}
+
+// An empty directory in the temporary directory.
+static std::filesystem::path empty_directory()
+{
+    const auto directory = temporary_path(
+        "libbitcoin_client_filter_synchronizer");
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+// A server chain of filters by height, and a store in a temporary directory.
+struct chain_fixture
+{
+    chain_fixture()
+      : directory(empty_directory()),
+        store(directory, 0),
+        batches(0),
+        requested(0),
+        corrupt(max_size_t)
+    {
+        BOOST_REQUIRE(store.open());
+
+        server.script("blockchain.fetch_last_height",
+            [this](const data_chunk&)
+            {
+                return height_payload(static_cast<uint32_t>(
+                    chain.size() - 1u));
+            });
+
+        // [type:1][start:4][stop:4]
+        server.script("blockchain.fetch_compact_filter_headers",
+            [this](const data_chunk& request)
+            {
+                ++batches;
+                const auto start = from_little_endian_unsafe<uint32_t>(
+                    request.data() + 1);
+                const auto stop = from_little_endian_unsafe<uint32_t>(
+                    request.data() + 5);
+
+                if (start > stop || stop >= chain.size())
+                    return code_payload(error::not_found);
+
+                const auto headers = filter_headers(chain);
+                data_chunk data;
+                data_sink ostream(data);
+                ostream_writer sink(ostream);
+                sink.write_error_code(error::success);
+                sink.write_byte(0);
+                sink.write_hash(chain[stop].block_hash);
+                sink.write_hash(start == 0 ? null_hash : headers[start - 1]);
+                sink.write_variable_little_endian(stop - start + 1u);
+
+                for (auto height = start; height <= stop; ++height)
+                    sink.write_hash(bitcoin_hash(chain[height].filter));
+
+                ostream.flush();
+                return data;
+            });
+
+        // [type:1][height:4]
+        server.script("blockchain.fetch_compact_filter",
+            [this](const data_chunk& request)
+            {
+                ++requested;
+                const auto height = from_little_endian_unsafe<uint32_t>(
+                    request.data() + 1);
+
+                if (height >= chain.size())
+                    return code_payload(error::not_found);
+
+                auto filter = chain[height].filter;
+                if (height == corrupt)
+                    filter.push_back(0);
+
+                data_chunk data;
+                data_sink ostream(data);
+                ostream_writer sink(ostream);
+                sink.write_error_code(error::success);
+                sink.write_byte(0);
+                sink.write_hash(chain[height].block_hash);
+                sink.write_variable_little_endian(filter.size());
+                sink.write_bytes(filter);
+                ostream.flush();
+                return data;
+            });
+
+        BOOST_REQUIRE(server.start());
+        BOOST_REQUIRE(client.connect(server.endpoint()));
+    }
+
+    ~chain_fixture()
+    {
+        store.close();
+        std::filesystem::remove_all(directory);
+    }
+
+    bool fill(const std::vector<block_filter>& blocks, size_t count)
+    {
+        for (size_t height = store.size(); height < count; ++height)
+            if (!store.push(blocks[height].block_hash, blocks[height].filter))
+                return false;
+
+        return true;
+    }
+
+    const std::filesystem::path directory;
+    filter_store store;
+    obelisk_server server;
+    obelisk_client client{ 0 };
+    std::vector<block_filter> chain;
+    std::atomic<size_t> batches;
+    std::atomic<size_t> requested;
+    std::atomic<size_t> corrupt;
+};
+
+BOOST_FIXTURE_TEST_SUITE(filter_synchronizer_tests, chain_fixture)
+
+BOOST_AUTO_TEST_CASE(filter_synchronizer__synchronize__empty_store__full_chain)
+{
+    chain = make_chain(250);
+    filter_synchronizer synchronizer(client, store, 100, 8);
+
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    BOOST_REQUIRE(synchronizer.synchronizing());
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE(!synchronizer.synchronizing());
+    BOOST_REQUIRE_EQUAL(store.size(), 250u);
+    BOOST_REQUIRE_EQUAL(batches.load(), 3u);
+    BOOST_REQUIRE(store.top_header() == filter_headers(chain).back());
+
+    size_t height;
+    BOOST_REQUIRE(store.get(height, chain[123].block_hash));
+    BOOST_REQUIRE_EQUAL(height, 123u);
+
+    data_chunk filter;
+    BOOST_REQUIRE(store.get(filter, 123));
+    BOOST_REQUIRE(filter == chain[123].filter);
+}
+
+BOOST_AUTO_TEST_CASE(filter_synchronizer__synchronize__partial_store__fetches_delta)
+{
+    chain = make_chain(50);
+    BOOST_REQUIRE(fill(chain, 40));
+
+    filter_synchronizer synchronizer(client, store);
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 50u);
+    BOOST_REQUIRE_EQUAL(requested.load(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(filter_synchronizer__synchronize__stale_top__reorganized)
+{
+    // The store followed a branch that the server's chain does not have.
+    const auto branch = make_chain(10, 1);
+    chain = make_chain(15);
+    BOOST_REQUIRE(fill(chain, 8));
+    BOOST_REQUIRE(fill(branch, 10));
+
+    filter_synchronizer synchronizer(client, store, 4);
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 15u);
+    BOOST_REQUIRE(store.top_header() == filter_headers(chain).back());
+
+    hash_digest hash;
+    BOOST_REQUIRE(store.block_hash(hash, 8));
+    BOOST_REQUIRE(hash == chain[8].block_hash);
+}
+
+BOOST_AUTO_TEST_CASE(filter_synchronizer__synchronize__filter_not_hashed__bad_stream)
+{
+    chain = make_chain(30);
+    corrupt = 12;
+
+    filter_synchronizer synchronizer(client, store, 10, 4);
+    code result = error::success;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::bad_stream);
+    BOOST_REQUIRE_EQUAL(store.size(), 12u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// A file in the temporary directory, removed on construction and destruction.
+struct store_fixture
+{
+    store_fixture()
+      : path(temporary_path("libbitcoin_client_header_store"))
+    {
+        std::filesystem::remove(path);
+    }
+
+    ~store_fixture()
+    {
+        std::filesystem::remove(path);
+    }
+
+    const std::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(header_store_tests, store_fixture)
+
+BOOST_AUTO_TEST_CASE(header_store__open__new__empty)
+{
+    header_store store(path);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(store.empty());
+    BOOST_REQUIRE_EQUAL(store.size(), 0u);
+
+    header out;
+    BOOST_REQUIRE(!store.get(out, 0));
+}
+
+BOOST_AUTO_TEST_CASE(header_store__push__chain__lookups_by_height_and_hash)
+{
+    const auto chain = header_chain(3000);
+    header_store store(path);
+    BOOST_REQUIRE(store.open());
+
+    for (const auto& header: chain)
+        BOOST_REQUIRE(store.push(header));
+
+    BOOST_REQUIRE_EQUAL(store.size(), chain.size());
+
+    for (size_t height = 0; height < chain.size(); ++height)
+    {
+        header out;
+        BOOST_REQUIRE(store.get(out, height));
+        BOOST_REQUIRE(out.hash() == chain[height].hash());
+
+        hash_digest hash;
+        BOOST_REQUIRE(store.get(hash, height));
+        BOOST_REQUIRE(hash == chain[height].hash());
+
+        size_t found;
+        BOOST_REQUIRE(store.get(found, chain[height].hash()));
+        BOOST_REQUIRE_EQUAL(found, height);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(header_store__get__unknown_hash__false)
+{
+    header_store store(path);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE(store.push(header_chain(1).front()));
+
+    size_t height;
+    BOOST_REQUIRE(!store.get(height, header_chain(1, 42).front().hash()));
+}
+
+BOOST_AUTO_TEST_CASE(header_store__open__reopened__persisted_and_indexed)
+{
+    const auto chain = header_chain(10);
+    {
+        header_store store(path);
+        BOOST_REQUIRE(store.open());
+        for (const auto& header: chain)
+            BOOST_REQUIRE(store.push(header));
+
+        BOOST_REQUIRE(store.close());
+    }
+
+    header_store store(path);
+    BOOST_REQUIRE(store.open());
+    BOOST_REQUIRE_EQUAL(store.size(), 10u);
+
+    size_t height;
+    BOOST_REQUIRE(store.get(height, chain[7].hash()));
+    BOOST_REQUIRE_EQUAL(height, 7u);
+}
+
+BOOST_AUTO_TEST_CASE(header_store__truncate__top__dropped_and_unindexed)
+{
+    const auto chain = header_chain(10);
+    header_store store(path);
+    BOOST_REQUIRE(store.open());
+    for (const auto& header: chain)
+        BOOST_REQUIRE(store.push(header));
+
+    BOOST_REQUIRE(store.truncate(8));
+    BOOST_REQUIRE_EQUAL(store.size(), 8u);
+
+    size_t height;
+    BOOST_REQUIRE(!store.get(height, chain[8].hash()));
+    BOOST_REQUIRE(store.get(height, chain[7].hash()));
+
+    // A competing header replaces the dropped height.
+    const auto other = header_chain(9, 1);
+    BOOST_REQUIRE(store.push(chain[8]));
+    BOOST_REQUIRE(store.truncate(8));
+    BOOST_REQUIRE(store.push(other[8]));
+    BOOST_REQUIRE(store.get(height, other[8].hash()));
+    BOOST_REQUIRE_EQUAL(height, 8u);
+}
+
+BOOST_AUTO_TEST_CASE(header_store__push__closed__false)
+{
+    header_store store(path);
+    BOOST_REQUIRE(!store.push(header_chain(1).front()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/obelisk_server.hpp"
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+// A server chain of headers by height, and a store in a temporary file.
+struct chain_fixture
+{
+    chain_fixture()
+      : path(temporary_path("libbitcoin_client_header_synchronizer")),
+        store(path),
+        requested(0)
+    {
+        std::filesystem::remove(path);
+        BOOST_REQUIRE(store.open());
+
+        server.script("blockchain.fetch_last_height",
+            [this](const data_chunk&)
+            {
+                return height_payload(static_cast<uint32_t>(
+                    chain.size() - 1u));
+            });
+
+        server.script("blockchain.fetch_block_header",
+            [this](const data_chunk& request)
+            {
+                ++requested;
+                const auto height = from_little_endian_unsafe<uint32_t>(
+                    request.data());
+
+                if (height >= chain.size())
+                    return code_payload(error::not_found);
+
+                return build_chunk(
+                {
+                    code_payload(),
+                    chain[height].to_data()
+                });
+            });
+
+        BOOST_REQUIRE(server.start());
+        BOOST_REQUIRE(client.connect(server.endpoint()));
+    }
+
+    ~chain_fixture()
+    {
+        store.close();
+        std::filesystem::remove(path);
+    }
+
+    const std::filesystem::path path;
+    header_store store;
+    obelisk_server server;
+    obelisk_client client{ 0 };
+    std::vector<header> chain;
+    std::atomic<size_t> requested;
+};
+
+BOOST_FIXTURE_TEST_SUITE(header_synchronizer_tests, chain_fixture)
+
+BOOST_AUTO_TEST_CASE(header_synchronizer__synchronize__empty_store__full_chain)
+{
+    chain = header_chain(200);
+    header_synchronizer synchronizer(client, store, 16);
+
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    BOOST_REQUIRE(synchronizer.synchronizing());
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE(!synchronizer.synchronizing());
+    BOOST_REQUIRE_EQUAL(store.size(), 200u);
+
+    size_t height;
+    BOOST_REQUIRE(store.get(height, chain[123].hash()));
+    BOOST_REQUIRE_EQUAL(height, 123u);
+}
+
+BOOST_AUTO_TEST_CASE(header_synchronizer__synchronize__partial_store__fetches_delta)
+{
+    chain = header_chain(50);
+    for (size_t height = 0; height < 40; ++height)
+        BOOST_REQUIRE(store.push(chain[height]));
+
+    header_synchronizer synchronizer(client, store);
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 50u);
+    BOOST_REQUIRE_EQUAL(requested.load(), 10u);
+}
+
+BOOST_AUTO_TEST_CASE(header_synchronizer__synchronize__stale_top__reorganized)
+{
+    // The store followed a branch that the server's chain does not have.
+    const auto branch = header_chain(12, 1);
+    chain = header_chain(15);
+    for (size_t height = 0; height < 10; ++height)
+        BOOST_REQUIRE(store.push(chain[height]));
+
+    BOOST_REQUIRE(store.truncate(8));
+    BOOST_REQUIRE(store.push(branch[8]));
+    BOOST_REQUIRE(store.push(branch[9]));
+
+    header_synchronizer synchronizer(client, store, 4);
+    code result = error::operation_failed;
+    synchronizer.synchronize([&result](const code& ec)
+    {
+        result = ec;
+    });
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 15u);
+
+    hash_digest hash;
+    BOOST_REQUIRE(store.get(hash, 8));
+    BOOST_REQUIRE(hash == chain[8].hash());
+}
+
+BOOST_AUTO_TEST_CASE(header_synchronizer__update__linked__appended_without_fetch)
+{
+    chain = header_chain(5);
+    for (size_t height = 0; height < 4; ++height)
+        BOOST_REQUIRE(store.push(chain[height]));
+
+    header_synchronizer synchronizer(client, store);
+    code result = error::operation_failed;
+    BOOST_REQUIRE(synchronizer.update(chain[4], [&result](const code& ec)
+    {
+        result = ec;
+    }));
+
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 5u);
+    BOOST_REQUIRE_EQUAL(requested.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(header_synchronizer__update__unlinked__synchronized)
+{
+    chain = header_chain(8);
+    for (size_t height = 0; height < 4; ++height)
+        BOOST_REQUIRE(store.push(chain[height]));
+
+    header_synchronizer synchronizer(client, store);
+    code result = error::operation_failed;
+    BOOST_REQUIRE(!synchronizer.update(chain[7], [&result](const code& ec)
+    {
+        result = ec;
+    }));
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(result, error::success);
+    BOOST_REQUIRE_EQUAL(store.size(), 8u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
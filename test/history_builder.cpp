@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+static hash_digest hash_of(uint32_t value)
+{
+    auto hash = null_hash;
+    hash[0] = static_cast<uint8_t>(value);
+    hash[1] = static_cast<uint8_t>(value >> 8);
+    hash[2] = static_cast<uint8_t>(value >> 16);
+    hash[31] = 0x42;
+    return hash;
+}
+
+static output_point output_of(uint32_t value)
+{
+    return { hash_of(value), value };
+}
+
+static input_point spend_of(uint32_t value)
+{
+    return { hash_of(value), value + 1 };
+}
+
+BOOST_AUTO_TEST_SUITE(history_builder_tests)
+
+BOOST_AUTO_TEST_CASE(history_builder__finish__empty__empty)
+{
+    history_builder builder(0);
+    BOOST_REQUIRE(builder.finish().empty());
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add_output__unspent__null_spend)
+{
+    history_builder builder(1);
+    builder.add_output(output_of(1), 10, 500);
+
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].output == output_of(1));
+    BOOST_REQUIRE_EQUAL(rows[0].output_height, 10u);
+    BOOST_REQUIRE_EQUAL(rows[0].value, 500u);
+    BOOST_REQUIRE(rows[0].spend.is_null());
+    BOOST_REQUIRE_EQUAL(rows[0].spend_height, max_uint64);
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add_spend__after_output__correlated)
+{
+    history_builder builder(2);
+    builder.add_output(output_of(1), 10, 500);
+    builder.add_spend(spend_of(2), 20, output_of(1).checksum());
+
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].spend == spend_of(2));
+    BOOST_REQUIRE_EQUAL(rows[0].spend_height, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add_spend__before_output__correlated)
+{
+    history_builder builder(2);
+    builder.add_spend(spend_of(2), 20, output_of(1).checksum());
+    builder.add_output(output_of(1), 10, 500);
+
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].output == output_of(1));
+    BOOST_REQUIRE(rows[0].spend == spend_of(2));
+    BOOST_REQUIRE_EQUAL(rows[0].spend_height, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add_spend__no_output__spend_only_row_last)
+{
+    history_builder builder(3);
+    builder.add_spend(spend_of(9), 20, output_of(9).checksum());
+    builder.add_output(output_of(1), 10, 500);
+    builder.add_spend(spend_of(8), 30, output_of(8).checksum());
+
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 3u);
+    BOOST_REQUIRE(rows[0].output == output_of(1));
+    BOOST_REQUIRE(rows[0].spend.is_null());
+    BOOST_REQUIRE(rows[1].output.is_null());
+    BOOST_REQUIRE_EQUAL(rows[1].output_height, max_size_t);
+    BOOST_REQUIRE(rows[1].spend == spend_of(9));
+    BOOST_REQUIRE_EQUAL(rows[1].spend_height, 20u);
+    BOOST_REQUIRE(rows[2].spend == spend_of(8));
+    BOOST_REQUIRE_EQUAL(rows[2].spend_height, 30u);
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add_spend__colliding_outputs__spent_in_order)
+{
+    history_builder builder(4);
+    builder.add_output(output_of(1), 10, 500);
+    builder.add_output(output_of(1), 11, 600);
+    builder.add_spend(spend_of(2), 20, output_of(1).checksum());
+
+    auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 2u);
+    BOOST_REQUIRE(rows[0].spend == spend_of(2));
+    BOOST_REQUIRE(rows[1].spend.is_null());
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__complete_output__spends_first__rows_not_held)
+{
+    history_builder builder(2, history_builder::spends_only);
+    builder.add_spend(spend_of(2), 20, output_of(1).checksum());
+    builder.add_spend(spend_of(9), 30, output_of(9).checksum());
+
+    const auto spent = builder.complete_output(output_of(1), 10, 500);
+    BOOST_REQUIRE(spent.output == output_of(1));
+    BOOST_REQUIRE(spent.spend == spend_of(2));
+    BOOST_REQUIRE_EQUAL(spent.spend_height, 20u);
+
+    const auto unspent = builder.complete_output(output_of(3), 11, 600);
+    BOOST_REQUIRE(unspent.spend.is_null());
+    BOOST_REQUIRE_EQUAL(unspent.spend_height, max_uint64);
+
+    // Only the uncorrelated spend remains.
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+    BOOST_REQUIRE(rows[0].output.is_null());
+    BOOST_REQUIRE(rows[0].spend == spend_of(9));
+}
+
+BOOST_AUTO_TEST_CASE(history_builder__add__beyond_hint__all_correlated)
+{
+    static const uint32_t outputs = 1000;
+    history_builder builder(0);
+
+    for (uint32_t value = 0; value < outputs; ++value)
+        builder.add_output(output_of(value), value, value);
+
+    for (auto value = outputs; value > 0; --value)
+        builder.add_spend(spend_of(value - 1), value,
+            output_of(value - 1).checksum());
+
+    const auto rows = builder.finish();
+    BOOST_REQUIRE_EQUAL(rows.size(), outputs);
+
+    for (uint32_t value = 0; value < outputs; ++value)
+    {
+        BOOST_REQUIRE(rows[value].output == output_of(value));
+        BOOST_REQUIRE(rows[value].spend == spend_of(value));
+        BOOST_REQUIRE_EQUAL(rows[value].spend_height, value + 1u);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+static hash_digest hash_of(uint8_t value)
+{
+    auto hash = null_hash;
+    hash[0] = value;
+    return hash;
+}
+
+static const input_point null_spend{ null_hash, point::null_index };
+
+BOOST_AUTO_TEST_SUITE(history_columns_tests)
+
+BOOST_AUTO_TEST_CASE(history_columns__construct__empty)
+{
+    const history_columns columns;
+    BOOST_REQUIRE(columns.empty());
+    BOOST_REQUIRE_EQUAL(columns.size(), 0u);
+    BOOST_REQUIRE_EQUAL(columns.balance(), 0u);
+    BOOST_REQUIRE_EQUAL(columns.unspent(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(history_columns__emplace_back__row__round_trips)
+{
+    history_columns columns;
+    const output_point output{ hash_of(1), 2 };
+    const input_point spend{ hash_of(3), 4 };
+    columns.emplace_back(output, 10, 500, spend, 20);
+
+    BOOST_REQUIRE_EQUAL(columns.size(), 1u);
+    const auto row = columns.row(0);
+    BOOST_REQUIRE(row.output == output);
+    BOOST_REQUIRE_EQUAL(row.output_height, 10u);
+    BOOST_REQUIRE_EQUAL(row.value, 500u);
+    BOOST_REQUIRE(row.spend == spend);
+    BOOST_REQUIRE_EQUAL(row.spend_height, 20u);
+}
+
+BOOST_AUTO_TEST_CASE(history_columns__set_spend__unspent_row__spent)
+{
+    history_columns columns;
+    columns.emplace_back({ hash_of(1), 2 }, 10, 500, null_spend, max_uint64);
+    BOOST_REQUIRE_EQUAL(columns.unspent(), 1u);
+
+    set_spend(columns, 0, { hash_of(3), 4 }, 20);
+    BOOST_REQUIRE(columns.row(0).spend == input_point(hash_of(3), 4));
+    BOOST_REQUIRE_EQUAL(columns.spend_heights[0], 20u);
+    BOOST_REQUIRE_EQUAL(columns.unspent(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(history_columns__balance__mixed_rows__unspent_outputs_only)
+{
+    history_columns columns;
+    columns.emplace_back({ hash_of(1), 0 }, 10, 100, null_spend, max_uint64);
+    columns.emplace_back({ hash_of(2), 0 }, 11, 200, { hash_of(5), 0 }, 12);
+    columns.emplace_back({ hash_of(3), 0 }, 13, 400, null_spend, max_uint64);
+
+    // A spend-only row, of an output below the history height cutoff.
+    columns.emplace_back({ null_hash, point::null_index }, max_size_t,
+        max_uint64, { hash_of(6), 0 }, 14);
+
+    BOOST_REQUIRE_EQUAL(columns.balance(), 500u);
+    BOOST_REQUIRE_EQUAL(columns.unspent(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(history_columns__builder__spend_before_output__correlated)
+{
+    const output_point output{ hash_of(1), 2 };
+    history_columns_builder builder(2);
+    builder.add_spend({ hash_of(3), 4 }, 20, output.checksum());
+    builder.add_output(output, 10, 500);
+    builder.add_output({ hash_of(7), 0 }, 11, 300);
+
+    const auto columns = builder.finish();
+    BOOST_REQUIRE_EQUAL(columns.size(), 2u);
+    BOOST_REQUIRE_EQUAL(columns.spend_heights[0], 20u);
+    BOOST_REQUIRE_EQUAL(columns.spend_heights[1], max_uint64);
+    BOOST_REQUIRE_EQUAL(columns.balance(), 300u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,218 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/obelisk_server.hpp"
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+using namespace bc::system;
+using namespace bc::system::chain;
+
+static hash_digest hash_of(uint8_t value)
+{
+    auto hash = null_hash;
+    hash[0] = value;
+    return hash;
+}
+
+static const hash_digest test_key = hash_of('k');
+static const output_point output_a{ hash_of('a'), 0 };
+static const output_point output_b{ hash_of('b'), 1 };
+static const output_point output_c{ hash_of('c'), 0 };
+static const output_point output_d{ hash_of('d'), 0 };
+static const input_point spend_a{ hash_of('s'), 0 };
+
+// A chain of history rows, of which the server returns those at or above
+// the requested height and at or below the tip.
+struct chain_fixture
+{
+    chain_fixture()
+      : tip(0), requested(max_uint32)
+    {
+        rows =
+        {
+            { true, output_a, 10, 100 },
+            { true, output_b, 20, 200 },
+            { true, output_c, 30, 300 },
+            { false, spend_a, 30, output_a.checksum() }
+        };
+
+        server.script("blockchain.fetch_history4",
+            [this](const data_chunk& request)
+            {
+                const auto from = from_little_endian_unsafe<uint32_t>(
+                    request.data() + hash_size);
+                requested = from;
+
+                std::vector<payment_row> reported;
+                for (const auto& row: rows)
+                    if (row.height >= from && row.height <= tip)
+                        reported.push_back(row);
+
+                return history_payload(reported);
+            });
+
+        BOOST_REQUIRE(server.start());
+        BOOST_REQUIRE(client.connect(server.endpoint()));
+    }
+
+    obelisk_server server;
+    obelisk_client client{ 0 };
+    std::vector<payment_row> rows;
+    std::atomic<uint32_t> tip;
+    std::atomic<uint32_t> requested;
+};
+
+BOOST_FIXTURE_TEST_SUITE(history_synchronizer_tests, chain_fixture)
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__synchronize__first__full_history)
+{
+    tip = 20;
+    history_synchronizer synchronizer(client);
+
+    history::list received;
+    synchronizer.synchronize([&](const code& ec, const history::list& rows)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received = rows;
+    }, test_key);
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(requested.load(), 0u);
+    BOOST_REQUIRE_EQUAL(received.size(), 2u);
+    BOOST_REQUIRE_EQUAL(synchronizer.size(), 1u);
+    BOOST_REQUIRE_EQUAL(synchronizer.from_height(test_key),
+        20u - history_synchronizer::default_overlap);
+}
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__synchronize__delta__spend_merged)
+{
+    tip = 20;
+    history_synchronizer synchronizer(client);
+    const auto ignore = [](const code&, const history::list&) {};
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+
+    tip = 30;
+    history::list received;
+    synchronizer.synchronize([&](const code& ec, const history::list& rows)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received = rows;
+    }, test_key);
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(requested.load(), 14u);
+    BOOST_REQUIRE_EQUAL(received.size(), 3u);
+    BOOST_REQUIRE(received[0].output == output_a);
+    BOOST_REQUIRE(received[0].spend == spend_a);
+    BOOST_REQUIRE_EQUAL(received[0].spend_height, 30u);
+    BOOST_REQUIRE(received[1].output == output_b);
+    BOOST_REQUIRE(received[1].spend.is_null());
+    BOOST_REQUIRE(received[2].output == output_c);
+    BOOST_REQUIRE_EQUAL(synchronizer.from_height(test_key), 24u);
+}
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__synchronize__reorganized__rows_replaced)
+{
+    tip = 20;
+    history_synchronizer synchronizer(client);
+    const auto ignore = [](const code&, const history::list&) {};
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+
+    // The block at 20 is replaced by one paying output d rather than b.
+    rows[1] = { true, output_d, 20, 400 };
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+
+    const auto cached = synchronizer.cached(test_key);
+    BOOST_REQUIRE_EQUAL(cached.size(), 2u);
+    BOOST_REQUIRE(cached[0].output == output_a);
+    BOOST_REQUIRE(cached[1].output == output_d);
+    BOOST_REQUIRE_EQUAL(cached[1].value, 400u);
+}
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__synchronize__reorganized_shorter__rows_dropped_height_lowered)
+{
+    tip = 30;
+    history_synchronizer synchronizer(client);
+    const auto ignore = [](const code&, const history::list&) {};
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+    BOOST_REQUIRE_EQUAL(synchronizer.from_height(test_key), 24u);
+
+    // The block at 30 is replaced by a chain without rows of the key.
+    tip = 25;
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+
+    const auto cached = synchronizer.cached(test_key);
+    BOOST_REQUIRE_EQUAL(cached.size(), 2u);
+    BOOST_REQUIRE(cached[0].output == output_a);
+    BOOST_REQUIRE(cached[0].spend.is_null());
+    BOOST_REQUIRE(cached[1].output == output_b);
+    BOOST_REQUIRE_EQUAL(synchronizer.from_height(test_key), 14u);
+}
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__synchronize__failed__cache_unchanged)
+{
+    tip = 20;
+    history_synchronizer synchronizer(client);
+    server.set_latency(500);
+
+    code result;
+    size_t received = 1;
+    synchronizer.synchronize([&](const code& ec, const history::list& rows)
+    {
+        result = ec;
+        received = rows.size();
+    }, test_key);
+
+    client.wait(50);
+    BOOST_REQUIRE_EQUAL(result, error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(received, 0u);
+    BOOST_REQUIRE_EQUAL(synchronizer.size(), 0u);
+    BOOST_REQUIRE_EQUAL(synchronizer.from_height(test_key), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(history_synchronizer__forget__synchronized__refetched_in_full)
+{
+    tip = 30;
+    history_synchronizer synchronizer(client);
+    const auto ignore = [](const code&, const history::list&) {};
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+
+    synchronizer.forget(test_key);
+    BOOST_REQUIRE_EQUAL(synchronizer.size(), 0u);
+
+    synchronizer.synchronize(ignore, test_key);
+    client.wait();
+    BOOST_REQUIRE_EQUAL(requested.load(), 0u);
+    BOOST_REQUIRE_EQUAL(synchronizer.cached(test_key).size(), 3u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
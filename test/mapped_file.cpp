@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+#include "mock/payload.hpp"
+
+using namespace bc::client;
+using namespace bc::client::mock;
+
+// A file in the temporary directory, removed on construction and destruction.
+struct file_fixture
+{
+    file_fixture()
+      : path(temporary_path("libbitcoin_client_mapped_file"))
+    {
+        std::filesystem::remove(path);
+    }
+
+    ~file_fixture()
+    {
+        std::filesystem::remove(path);
+    }
+
+    const std::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(mapped_file_tests, file_fixture)
+
+BOOST_AUTO_TEST_CASE(mapped_file__open__missing__created_empty)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE(file.is_open());
+    BOOST_REQUIRE_EQUAL(file.size(), 0u);
+    BOOST_REQUIRE(file.data() == nullptr);
+    BOOST_REQUIRE(std::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__open__twice__false)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE(!file.open());
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__resize__grown__zero_filled)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE(file.resize(100));
+    BOOST_REQUIRE_EQUAL(file.size(), 100u);
+    BOOST_REQUIRE_EQUAL(std::filesystem::file_size(path), 100u);
+
+    for (size_t index = 0; index < file.size(); ++index)
+        BOOST_REQUIRE_EQUAL(file.data()[index], 0u);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__close__written__persisted)
+{
+    {
+        mapped_file file(path);
+        BOOST_REQUIRE(file.open());
+        BOOST_REQUIRE(file.resize(4));
+        file.data()[0] = 'a';
+        file.data()[3] = 'z';
+        BOOST_REQUIRE(file.close());
+        BOOST_REQUIRE(!file.is_open());
+    }
+
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE_EQUAL(file.size(), 4u);
+    BOOST_REQUIRE_EQUAL(file.data()[0], 'a');
+    BOOST_REQUIRE_EQUAL(file.data()[3], 'z');
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__resize__shrunk__prefix_kept)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE(file.resize(8));
+    file.data()[1] = 42;
+    BOOST_REQUIRE(file.resize(2));
+    BOOST_REQUIRE_EQUAL(file.size(), 2u);
+    BOOST_REQUIRE_EQUAL(file.data()[1], 42u);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__reserve__small_increment__grows_by_half)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(file.open());
+    BOOST_REQUIRE(file.resize(100));
+    BOOST_REQUIRE(file.reserve(101));
+    BOOST_REQUIRE_EQUAL(file.size(), 150u);
+
+    // A reservation within the size does not resize.
+    BOOST_REQUIRE(file.reserve(120));
+    BOOST_REQUIRE_EQUAL(file.size(), 150u);
+}
+
+BOOST_AUTO_TEST_CASE(mapped_file__resize__closed__false)
+{
+    mapped_file file(path);
+    BOOST_REQUIRE(!file.resize(10));
+    BOOST_REQUIRE(file.close());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
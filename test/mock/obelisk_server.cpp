@@ -0,0 +1,308 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "obelisk_server.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <zmq.h>
+#include "payload.hpp"
+
+using namespace bc::protocol;
+using namespace bc::system;
+using namespace std::chrono;
+
+namespace libbitcoin {
+namespace client {
+namespace mock {
+
+// Arbitrary values reported by the default scripts.
+static constexpr uint32_t mock_height = 800001;
+static constexpr uint32_t mock_index = 1;
+
+// Requests arrive as [identity][delimiter][command][id][payload].
+static constexpr size_t request_frames = 5;
+
+const std::string obelisk_server::default_address("tcp://127.0.0.1:*");
+
+obelisk_server::obelisk_server(const std::string& address)
+  : address_(address),
+    latency_(0),
+    requests_(0),
+    response_size_(1)
+{
+    script_defaults();
+}
+
+obelisk_server::~obelisk_server()
+{
+    stop();
+}
+
+bool obelisk_server::start()
+{
+    if (thread_.joinable())
+        return false;
+
+    std::promise<bool> started;
+    auto bound = started.get_future();
+    thread_ = std::thread(&obelisk_server::run, this, std::ref(started));
+    return bound.get();
+}
+
+void obelisk_server::stop()
+{
+    // Terminating the context aborts the poller and closes the socket.
+    context_.stop();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void obelisk_server::set_latency(uint32_t milliseconds)
+{
+    latency_ = milliseconds;
+}
+
+void obelisk_server::set_response_size(size_t size)
+{
+    response_size_ = size;
+}
+
+void obelisk_server::script(const std::string& command, responder handler)
+{
+    scripts_[command] = handler;
+}
+
+size_t obelisk_server::requests() const
+{
+    return requests_;
+}
+
+const config::endpoint& obelisk_server::endpoint() const
+{
+    return endpoint_;
+}
+
+// Default scripts cover every command registered by obelisk_client.
+void obelisk_server::script_defaults()
+{
+    const auto result = [](const data_chunk&)
+    {
+        return code_payload();
+    };
+
+    const auto transaction = [this](const data_chunk&)
+    {
+        return transaction_payload(response_size_);
+    };
+
+    const auto height = [](const data_chunk&)
+    {
+        return height_payload(mock_height);
+    };
+
+    const auto block = [this](const data_chunk&)
+    {
+        return block_payload(response_size_, mock_height);
+    };
+
+    const auto header = [](const data_chunk&)
+    {
+        return header_payload(mock_height);
+    };
+
+    const auto transaction_index = [](const data_chunk&)
+    {
+        return transaction_index_payload(mock_height, mock_index);
+    };
+
+    const auto history = [this](const data_chunk&)
+    {
+        return history_payload(response_size_);
+    };
+
+    const auto hash_list = [this](const data_chunk&)
+    {
+        return hash_list_payload(response_size_);
+    };
+
+    const auto compact_filter = [this](const data_chunk&)
+    {
+        return compact_filter_payload(response_size_);
+    };
+
+    const auto compact_filter_checkpoint = [this](const data_chunk&)
+    {
+        return compact_filter_checkpoint_payload(response_size_);
+    };
+
+    const auto compact_filter_headers = [this](const data_chunk&)
+    {
+        return compact_filter_headers_payload(response_size_);
+    };
+
+    // The notification reports the subscribed key as the tx hash.
+    const auto notification = [](const data_chunk& request)
+    {
+        hash_digest key{};
+        std::copy_n(request.begin(), std::min(request.size(), key.size()),
+            key.begin());
+        return notification_payload(0, mock_height, key);
+    };
+
+    const auto version = [](const data_chunk&)
+    {
+        return version_payload();
+    };
+
+    scripts_["transaction_pool.broadcast"] = result;
+    scripts_["transaction_pool.validate2"] = result;
+    scripts_["transaction_pool.fetch_transaction"] = transaction;
+    scripts_["transaction_pool.fetch_transaction2"] = transaction;
+    scripts_["blockchain.broadcast"] = result;
+    scripts_["blockchain.validate"] = result;
+    scripts_["blockchain.fetch_transaction"] = transaction;
+    scripts_["blockchain.fetch_transaction2"] = transaction;
+    scripts_["blockchain.fetch_last_height"] = height;
+    scripts_["blockchain.fetch_block"] = block;
+    scripts_["blockchain.fetch_block_header"] = header;
+    scripts_["blockchain.fetch_block_height"] = height;
+    scripts_["blockchain.fetch_compact_filter"] = compact_filter;
+    scripts_["blockchain.fetch_compact_filter_checkpoint"] =
+        compact_filter_checkpoint;
+    scripts_["blockchain.fetch_compact_filter_headers"] =
+        compact_filter_headers;
+    scripts_["blockchain.fetch_transaction_index"] = transaction_index;
+    scripts_["blockchain.fetch_history4"] = history;
+    scripts_["blockchain.fetch_block_transaction_hashes"] = hash_list;
+    scripts_["subscribe.key"] = result;
+    scripts_["notification.key"] = notification;
+    scripts_["unsubscribe.key"] = result;
+    scripts_["server.version"] = version;
+}
+
+void obelisk_server::run(std::promise<bool>& started)
+{
+    zmq::socket socket(context_, zmq::socket::role::router);
+
+    // The address is bound directly, as the wildcard port is not an endpoint,
+    // and the bound endpoint is read back before start returns.
+    char bound[256];
+    auto size = sizeof(bound);
+    if (zmq_bind(socket.self(), address_.c_str()) != 0 ||
+        zmq_getsockopt(socket.self(), ZMQ_LAST_ENDPOINT, bound, &size) != 0)
+    {
+        started.set_value(false);
+        return;
+    }
+
+    endpoint_ = config::endpoint(std::string(bound));
+    started.set_value(true);
+
+    zmq::poller poller;
+    poller.add(socket);
+    reply_queue replies;
+
+    while (!poller.terminated())
+    {
+        const auto identifiers = poller.wait(next_timeout(replies));
+
+        if (identifiers.contains(socket.id()) && !answer(socket, replies))
+            break;
+
+        flush(socket, replies);
+    }
+}
+
+// Queue the scripted reply to one request, due after the current latency.
+bool obelisk_server::answer(zmq::socket& socket, reply_queue& replies)
+{
+    zmq::message request;
+    if (socket.receive(request))
+        return false;
+
+    if (request.size() != request_frames)
+        return true;
+
+    const auto identity = request.dequeue_data();
+    request.dequeue();
+
+    uint32_t id = 0;
+    std::string command;
+    data_chunk payload;
+    request.dequeue(command);
+    request.dequeue(id);
+    request.dequeue(payload);
+    ++requests_;
+
+    const auto due = steady_clock::now() + milliseconds(latency_.load());
+
+    const auto enqueue = [&](const std::string& name)
+    {
+        const auto script = scripts_.find(name);
+        if (script == scripts_.end())
+            return;
+
+        zmq::message reply;
+        reply.enqueue(identity);
+        reply.enqueue();
+        reply.enqueue(to_chunk(name));
+        reply.enqueue(to_chunk(to_little_endian(id)));
+        reply.enqueue(script->second(payload));
+        replies.emplace(due, std::move(reply));
+    };
+
+    enqueue(command);
+
+    // A subscription is followed by one notification under the same id.
+    if (command == "subscribe.key")
+        enqueue("notification.key");
+
+    return true;
+}
+
+// Send all replies that have come due, in order of due time.
+void obelisk_server::flush(zmq::socket& socket, reply_queue& replies)
+{
+    const auto now = steady_clock::now();
+    auto reply = replies.begin();
+
+    for (; reply != replies.end() && reply->first <= now; ++reply)
+        socket.send(reply->second);
+
+    replies.erase(replies.begin(), reply);
+}
+
+// Block indefinitely when nothing is pending, otherwise until next due.
+int32_t obelisk_server::next_timeout(const reply_queue& replies) const
+{
+    if (replies.empty())
+        return -1;
+
+    const auto remaining = ceil<milliseconds>(
+        replies.begin()->first - steady_clock::now()).count();
+
+    return static_cast<int32_t>(std::max<int64_t>(remaining, 0));
+}
+
+} // namespace mock
+} // namespace client
+} // namespace libbitcoin
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_TEST_MOCK_OBELISK_SERVER_HPP
+#define LIBBITCOIN_CLIENT_TEST_MOCK_OBELISK_SERVER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <bitcoin/system.hpp>
+#include <bitcoin/protocol.hpp>
+
+namespace libbitcoin {
+namespace client {
+namespace mock {
+
+/// In-process stand-in for an obelisk query server, for offline tests and
+/// benchmarks. Binds a router socket and answers each [command][id][payload]
+/// request with a scripted payload under the same command and id, after the
+/// configured latency. Every command registered by the client is scripted by
+/// default, with responses scaled by the configured response size.
+class obelisk_server
+{
+public:
+    typedef std::function<system::data_chunk(const system::data_chunk&)>
+        responder;
+
+    /// Default loopback address for tests (tcp, as inproc requires the
+    /// client and server to share a zeromq context), on a port chosen by the
+    /// system, so that concurrent test runs do not collide.
+    static const std::string default_address;
+
+    obelisk_server(const std::string& address=default_address);
+
+    /// Stops the server if running.
+    ~obelisk_server();
+
+    /// Bind the endpoint and start answering on a dedicated thread.
+    bool start();
+
+    /// Stop answering and join the server thread.
+    void stop();
+
+    /// Delay applied to each response (thread safe).
+    void set_latency(uint32_t milliseconds);
+
+    /// Count of repeated elements (rows, transactions, outputs, hashes or
+    /// filter bytes) in default responses (thread safe).
+    void set_response_size(size_t size);
+
+    /// Replace the response to the command, call before start.
+    void script(const std::string& command, responder handler);
+
+    /// Number of requests answered since start (thread safe).
+    size_t requests() const;
+
+    /// The endpoint to which clients should connect, as bound by start.
+    const system::config::endpoint& endpoint() const;
+
+private:
+    typedef std::chrono::steady_clock::time_point time_point;
+    typedef std::multimap<time_point, protocol::zmq::message> reply_queue;
+
+    void script_defaults();
+    void run(std::promise<bool>& started);
+    bool answer(protocol::zmq::socket& socket, reply_queue& replies);
+    void flush(protocol::zmq::socket& socket, reply_queue& replies);
+    int32_t next_timeout(const reply_queue& replies) const;
+
+    const std::string address_;
+    system::config::endpoint endpoint_;
+    protocol::zmq::context context_;
+    std::unordered_map<std::string, responder> scripts_;
+    std::atomic<uint32_t> latency_;
+    std::atomic<size_t> requests_;
+    std::atomic<size_t> response_size_;
+    std::thread thread_;
+};
+
+} // namespace mock
+} // namespace client
+} // namespace libbitcoin
+
+#endif
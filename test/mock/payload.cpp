@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "payload.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace bc::system;
+using namespace bc::system::chain;
+
+namespace libbitcoin {
+namespace client {
+namespace mock {
+
+// payment_record wire kinds.
+static constexpr uint8_t output_kind = 0;
+static constexpr uint8_t spend_kind = 1;
+
+// Arbitrary but distinct hash for the given discriminator and value.
+static hash_digest synthetic_hash(uint8_t discriminator, uint32_t value)
+{
+    return sha256_hash(build_chunk(
+    {
+        to_array(discriminator),
+        to_little_endian(value)
+    }));
+}
+
+static void write_transaction(ostream_writer& sink, size_t outputs,
+    uint32_t salt)
+{
+    // Pay-to-key-hash sized output script.
+    static const data_chunk script(25, 0x76);
+
+    sink.write_4_bytes_little_endian(1);
+
+    // One (non-coinbase) input, which disambiguates from witness marker.
+    sink.write_variable_little_endian(1);
+    sink.write_hash(synthetic_hash('i', salt));
+    sink.write_4_bytes_little_endian(salt);
+    sink.write_variable_little_endian(0);
+    sink.write_4_bytes_little_endian(max_uint32);
+
+    sink.write_variable_little_endian(outputs);
+    for (size_t index = 0; index < outputs; ++index)
+    {
+        sink.write_8_bytes_little_endian(1000 + index);
+        sink.write_variable_little_endian(script.size());
+        sink.write_bytes(script);
+    }
+
+    sink.write_4_bytes_little_endian(0);
+}
+
+static void write_header(ostream_writer& sink, uint32_t height)
+{
+    sink.write_4_bytes_little_endian(4);
+    sink.write_hash(synthetic_hash('p', height));
+    sink.write_hash(synthetic_hash('m', height));
+    sink.write_4_bytes_little_endian(1600000000 + height);
+    sink.write_4_bytes_little_endian(0x1d00ffff);
+    sink.write_4_bytes_little_endian(height);
+}
+
+data_chunk code_payload(const code& ec)
+{
+    return build_chunk(
+    {
+        to_little_endian(static_cast<uint32_t>(ec.value()))
+    });
+}
+
+data_chunk version_payload(const std::string& version)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        to_chunk(version)
+    });
+}
+
+data_chunk height_payload(uint32_t height)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        to_little_endian(height)
+    });
+}
+
+data_chunk transaction_index_payload(uint32_t height, uint32_t index)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        to_little_endian(height),
+        to_little_endian(index)
+    });
+}
+
+data_chunk transaction_data(size_t outputs, uint32_t salt)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    write_transaction(sink, outputs, salt);
+    ostream.flush();
+    return data;
+}
+
+data_chunk transaction_payload(size_t outputs, uint32_t salt)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        transaction_data(outputs, salt)
+    });
+}
+
+data_chunk header_payload(uint32_t height)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+    write_header(sink, height);
+    ostream.flush();
+    return data;
+}
+
+data_chunk block_data(size_t transactions, uint32_t height)
+{
+    // Two outputs per transaction approximates the mainnet average size.
+    static constexpr size_t outputs = 2;
+
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    write_header(sink, height);
+    sink.write_variable_little_endian(transactions);
+
+    for (size_t index = 0; index < transactions; ++index)
+        write_transaction(sink, outputs, static_cast<uint32_t>(index));
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk block_payload(size_t transactions, uint32_t height)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        block_data(transactions, height)
+    });
+}
+
+data_chunk hash_list_payload(size_t hashes)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+
+    for (size_t index = 0; index < hashes; ++index)
+        sink.write_hash(synthetic_hash('h', static_cast<uint32_t>(index)));
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk history_payload(size_t rows)
+{
+    data_chunk data;
+    data.reserve(sizeof(uint32_t) + rows * 49);
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+
+    // Even rows are outputs, odd rows spend the output in the previous row.
+    for (size_t row = 0; row < rows; ++row)
+    {
+        const auto value = static_cast<uint32_t>(row);
+
+        if (row % 2 == 0)
+        {
+            sink.write_byte(output_kind);
+            sink.write_hash(synthetic_hash('o', value));
+            sink.write_4_bytes_little_endian(value);
+            sink.write_4_bytes_little_endian(value);
+            sink.write_8_bytes_little_endian(1000 + row);
+        }
+        else
+        {
+            const output_point spent{ synthetic_hash('o', value - 1),
+                value - 1 };
+
+            sink.write_byte(spend_kind);
+            sink.write_hash(synthetic_hash('s', value));
+            sink.write_4_bytes_little_endian(0);
+            sink.write_4_bytes_little_endian(value);
+            sink.write_8_bytes_little_endian(spent.checksum());
+        }
+    }
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk history_payload(const std::vector<payment_row>& rows)
+{
+    data_chunk data;
+    data.reserve(sizeof(uint32_t) + rows.size() * 49);
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+
+    for (const auto& row: rows)
+    {
+        sink.write_byte(row.output ? output_kind : spend_kind);
+        sink.write_hash(row.point.hash());
+        sink.write_4_bytes_little_endian(row.point.index());
+        sink.write_4_bytes_little_endian(row.height);
+        sink.write_8_bytes_little_endian(row.value);
+    }
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk compact_filter_payload(size_t bytes, uint8_t type)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+    sink.write_byte(type);
+    sink.write_hash(synthetic_hash('b', 0));
+    sink.write_variable_little_endian(bytes);
+    sink.write_bytes(data_chunk(bytes, 0x42));
+    ostream.flush();
+    return data;
+}
+
+data_chunk compact_filter_checkpoint_payload(size_t headers, uint8_t type)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+    sink.write_byte(type);
+    sink.write_hash(synthetic_hash('b', 0));
+    sink.write_variable_little_endian(headers);
+
+    for (size_t index = 0; index < headers; ++index)
+        sink.write_hash(synthetic_hash('f', static_cast<uint32_t>(index)));
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk compact_filter_headers_payload(size_t hashes, uint8_t type)
+{
+    data_chunk data;
+    data_sink ostream(data);
+    ostream_writer sink(ostream);
+    sink.write_error_code(error::success);
+    sink.write_byte(type);
+    sink.write_hash(synthetic_hash('b', 0));
+    sink.write_hash(synthetic_hash('f', 0));
+    sink.write_variable_little_endian(hashes);
+
+    for (size_t index = 0; index < hashes; ++index)
+        sink.write_hash(synthetic_hash('f', static_cast<uint32_t>(index)));
+
+    ostream.flush();
+    return data;
+}
+
+data_chunk notification_payload(uint16_t sequence, uint32_t height,
+    const hash_digest& tx_hash)
+{
+    return build_chunk(
+    {
+        code_payload(),
+        to_little_endian(sequence),
+        to_little_endian(height),
+        tx_hash
+    });
+}
+
+std::vector<header> header_chain(size_t count, uint32_t salt)
+{
+    std::vector<header> headers;
+    auto previous = null_hash;
+
+    for (size_t height = 0; height < count; ++height)
+    {
+        headers.emplace_back(4, previous, null_hash,
+            static_cast<uint32_t>(height), 0x1d00ffff, salt);
+        previous = headers.back().hash();
+    }
+
+    return headers;
+}
+
+hash_digest block_hash_at(size_t height, uint8_t salt)
+{
+    auto hash = null_hash;
+    const auto bytes = to_little_endian(static_cast<uint64_t>(height));
+    std::copy(bytes.begin(), bytes.end(), hash.begin());
+    hash.back() = salt;
+    return hash;
+}
+
+data_chunk filter_at(size_t height, uint8_t salt)
+{
+    return data_chunk(1u + height % 50u, static_cast<uint8_t>(height + salt));
+}
+
+std::filesystem::path temporary_path(const std::string& name)
+{
+    // Random per process, as concurrent runs share the temporary directory.
+    static const auto process = std::random_device{}();
+    static std::atomic<size_t> calls{ 0 };
+
+    return std::filesystem::temp_directory_path() / (name + "_" +
+        std::to_string(process) + "_" + std::to_string(calls++));
+}
+
+} // namespace mock
+} // namespace client
+} // namespace libbitcoin
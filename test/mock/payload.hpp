@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_CLIENT_TEST_MOCK_PAYLOAD_HPP
+#define LIBBITCOIN_CLIENT_TEST_MOCK_PAYLOAD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <bitcoin/system.hpp>
+
+namespace libbitcoin {
+namespace client {
+namespace mock {
+
+/// Synthetic response payloads in the wire format of the obelisk server.
+/// Each payload is prefixed with the four byte response code, as read by
+/// the client response handlers. The count parameter scales the response
+/// (rows, transactions, outputs, hashes or filter bytes) so that callers can
+/// generate anything from tiny to multi-megabyte responses.
+
+/// [ code:4 ]
+system::data_chunk code_payload(const system::code& ec=system::error::success);
+
+/// [ code:4 ][ version:... ]
+system::data_chunk version_payload(const std::string& version="4.0.0");
+
+/// [ code:4 ][ height:4 ]
+system::data_chunk height_payload(uint32_t height);
+
+/// [ code:4 ][ height:4 ][ index:4 ]
+system::data_chunk transaction_index_payload(uint32_t height, uint32_t index);
+
+/// [ code:4 ][ tx:... ] with one input and the given number of outputs.
+system::data_chunk transaction_payload(size_t outputs, uint32_t salt=0);
+
+/// [ code:4 ][ header:80 ]
+system::data_chunk header_payload(uint32_t height=0);
+
+/// [ code:4 ][ block:... ] with the given number of transactions.
+system::data_chunk block_payload(size_t transactions, uint32_t height=0);
+
+/// [ code:4 ][ hash:32 ]...
+system::data_chunk hash_list_payload(size_t hashes);
+
+/// [ code:4 ][ record:49 ]... with outputs and spends of half the outputs.
+system::data_chunk history_payload(size_t rows);
+
+/// A history record, with the checksum of the spent output as the value of
+/// a spend.
+struct payment_row
+{
+    bool output;
+    system::chain::point point;
+    uint32_t height;
+    uint64_t value;
+};
+
+/// [ code:4 ][ record:49 ]... of the given records.
+system::data_chunk history_payload(const std::vector<payment_row>& rows);
+
+/// [ code:4 ][ type:1 ][ block_hash:32 ][ filter:var ]
+system::data_chunk compact_filter_payload(size_t bytes, uint8_t type=0);
+
+/// [ code:4 ][ type:1 ][ stop_hash:32 ][ headers:var ]
+system::data_chunk compact_filter_checkpoint_payload(size_t headers,
+    uint8_t type=0);
+
+/// [ code:4 ][ type:1 ][ stop_hash:32 ][ previous:32 ][ hashes:var ]
+system::data_chunk compact_filter_headers_payload(size_t hashes,
+    uint8_t type=0);
+
+/// [ code:4 ][ sequence:2 ][ height:4 ][ tx_hash:32 ]
+system::data_chunk notification_payload(uint16_t sequence, uint32_t height,
+    const system::hash_digest& tx_hash);
+
+/// The serialized transaction (without code) used by transaction_payload.
+system::data_chunk transaction_data(size_t outputs, uint32_t salt=0);
+
+/// The serialized block (without code) used by block_payload.
+system::data_chunk block_data(size_t transactions, uint32_t height=0);
+
+/// Fixtures shared by the store and synchronizer tests.
+
+/// A chain of headers, each linked to the one before it, varied by salt.
+std::vector<system::chain::header> header_chain(size_t count,
+    uint32_t salt=0);
+
+/// A block hash distinct in its first bytes for each height and salt.
+system::hash_digest block_hash_at(size_t height, uint8_t salt=0);
+
+/// A filter of varying size for each height and salt.
+system::data_chunk filter_at(size_t height, uint8_t salt=0);
+
+/// A path in the temporary directory with the given name as its prefix,
+/// unique to the process and the call so that test runs do not collide.
+std::filesystem::path temporary_path(const std::string& name);
+
+} // namespace mock
+} // namespace client
+} // namespace libbitcoin
+
+#endif
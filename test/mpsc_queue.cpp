@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+
+BOOST_AUTO_TEST_SUITE(mpsc_queue_tests)
+
+BOOST_AUTO_TEST_CASE(mpsc_queue__construct__empty)
+{
+    mpsc_queue<std::string> queue;
+    std::string value;
+    BOOST_REQUIRE(queue.empty());
+    BOOST_REQUIRE(!queue.pop(value));
+}
+
+BOOST_AUTO_TEST_CASE(mpsc_queue__pop__pushed__fifo_order)
+{
+    mpsc_queue<std::string> queue;
+    queue.push("a");
+    queue.push("b");
+    queue.push("c");
+    BOOST_REQUIRE(!queue.empty());
+
+    std::string value;
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_REQUIRE_EQUAL(value, "a");
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_REQUIRE_EQUAL(value, "b");
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_REQUIRE_EQUAL(value, "c");
+    BOOST_REQUIRE(!queue.pop(value));
+    BOOST_REQUIRE(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(mpsc_queue__destruct__unpopped__released)
+{
+    mpsc_queue<std::vector<int>> queue;
+    queue.push(std::vector<int>(100));
+    queue.push(std::vector<int>(100));
+}
+
+BOOST_AUTO_TEST_CASE(mpsc_queue__pop__concurrent_producers__per_producer_order)
+{
+    static const size_t producers = 4;
+    static const size_t values = 10000;
+
+    mpsc_queue<size_t> queue;
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; ++producer)
+        threads.emplace_back([&queue, producer]()
+        {
+            for (size_t value = 0; value < values; ++value)
+                queue.push(producer * values + value);
+        });
+
+    std::vector<size_t> next(producers, 0);
+    size_t popped = 0;
+    size_t value = 0;
+    auto ordered = true;
+
+    while (popped < producers * values)
+    {
+        if (!queue.pop(value))
+            continue;
+
+        const auto producer = value / values;
+        ordered &= (value % values == next[producer]++);
+        ++popped;
+    }
+
+    for (auto& thread: threads)
+        thread.join();
+
+    BOOST_REQUIRE(ordered);
+    BOOST_REQUIRE(queue.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -16,14 +16,21 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <future>
 #include <string>
+#include <thread>
+#include <vector>
 #include <boost/test/test_tools.hpp>
 #include <boost/test/unit_test_suite.hpp>
 #include <bitcoin/client.hpp>
 #include <bitcoin/protocol.hpp>
+#include "mock/obelisk_server.hpp"
 
 using namespace bc::client;
+using namespace bc::client::mock;
 using namespace bc::protocol;
 using namespace bc::system;
 using namespace bc::system::wallet;
@@ -44,6 +51,20 @@ static const char test_block_hash[] = "00000000002889eccd1262e2b7fe893b9839574d9
     obelisk_client client(retries); \
     client.connect(config::endpoint(testnet_url))
 
+#define MOCK_TEST_SETUP \
+    obelisk_server server; \
+    BOOST_REQUIRE(server.start()); \
+    static const uint32_t retries = 0; \
+    obelisk_client client(retries); \
+    BOOST_REQUIRE(client.connect(server.endpoint()))
+
+#define MOCK_DIRECT_TEST_SETUP \
+    obelisk_server server; \
+    BOOST_REQUIRE(server.start()); \
+    static const uint32_t retries = 0; \
+    obelisk_client client(retries, true); \
+    BOOST_REQUIRE(client.connect(server.endpoint()))
+
 BOOST_AUTO_TEST_SUITE(stub)
 
 BOOST_AUTO_TEST_CASE(client__dummy_test__ok)
@@ -53,6 +74,967 @@ BOOST_AUTO_TEST_CASE(client__dummy_test__ok)
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(offline)
+
+BOOST_AUTO_TEST_CASE(client__server_version__mock__expected)
+{
+    MOCK_TEST_SETUP;
+
+    std::string received_version;
+    const auto on_done = [&received_version](const code& ec,
+        const std::string& version)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received_version = version;
+    };
+
+    client.server_version(on_done);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(received_version, "4.0.0");
+    BOOST_REQUIRE_EQUAL(server.requests(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_last_height__mock_multi_handler__expected)
+{
+    MOCK_TEST_SETUP;
+
+    size_t calls = 0;
+    const auto on_done = [&calls](const code& ec, size_t height)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(height, test_height);
+        ++calls;
+    };
+
+    client.blockchain_fetch_last_height(on_done);
+    client.blockchain_fetch_last_height(on_done);
+    client.blockchain_fetch_last_height(on_done);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(calls, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_last_height__mock_direct_send_multi_handler__expected)
+{
+    MOCK_DIRECT_TEST_SETUP;
+
+    size_t calls = 0;
+    const auto on_done = [&calls](const code& ec, size_t height)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(height, test_height);
+        ++calls;
+    };
+
+    client.blockchain_fetch_last_height(on_done);
+    client.blockchain_fetch_last_height(on_done);
+    client.blockchain_fetch_last_height(on_done);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(calls, 3u);
+    BOOST_REQUIRE_EQUAL(server.requests(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(client__connect__settings_direct_send__expected)
+{
+    obelisk_server server;
+    BOOST_REQUIRE(server.start());
+
+    connection_settings settings;
+    settings.retries = 0;
+    settings.server = server.endpoint();
+    settings.direct_send = true;
+
+    obelisk_client client;
+    BOOST_REQUIRE(client.connect(settings));
+
+    std::string received_version;
+    const auto on_done = [&received_version](const code& ec,
+        const std::string& version)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received_version = version;
+    };
+
+    client.server_version(on_done);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(received_version, "4.0.0");
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_last_height__mock_latency_exceeds_wait__channel_timeout)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(500);
+
+    code result;
+    const auto on_done = [&result](const code& ec, size_t)
+    {
+        result = ec;
+    };
+
+    client.blockchain_fetch_last_height(on_done);
+    client.wait(50);
+
+    BOOST_REQUIRE_EQUAL(result, error::channel_timeout);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_compact_filter__mock_latency_exceeds_wait__channel_timeout)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(500);
+
+    code result;
+    const auto on_done = [&result](const code& ec,
+        const message::compact_filter&)
+    {
+        result = ec;
+    };
+
+    client.blockchain_fetch_compact_filter(on_done, 0, test_height);
+    client.wait(50);
+
+    BOOST_REQUIRE_EQUAL(result, error::channel_timeout);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_last_height__mock_request_timeout__expires_individually)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(200);
+
+    code short_result;
+    const auto on_short = [&short_result](const code& ec, size_t)
+    {
+        short_result = ec;
+    };
+
+    code long_result;
+    const auto on_long = [&long_result](const code& ec, size_t)
+    {
+        long_result = ec;
+    };
+
+    client.blockchain_fetch_last_height(on_short, 20);
+    client.blockchain_fetch_last_height(on_long, 5000);
+    client.wait(10000);
+
+    BOOST_REQUIRE_EQUAL(short_result, error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(long_result, error::success);
+}
+
+BOOST_AUTO_TEST_CASE(client__start__concurrent_fetchers__all_answered)
+{
+    MOCK_TEST_SETUP;
+    BOOST_REQUIRE(client.start());
+
+    static const size_t threads = 4;
+    static const size_t requests = 25;
+
+    // Handlers run on the reactor thread, so results are only counted there.
+    std::atomic<size_t> answered(0);
+    std::atomic<size_t> failed(0);
+    std::promise<void> completed;
+    const auto on_done = [&](const code& ec, size_t height)
+    {
+        if (ec || height != test_height)
+            ++failed;
+
+        if (++answered == threads * requests)
+            completed.set_value();
+    };
+
+    std::vector<std::thread> producers;
+    for (size_t thread = 0; thread < threads; ++thread)
+        producers.emplace_back([&]()
+        {
+            for (size_t request = 0; request < requests; ++request)
+                client.blockchain_fetch_last_height(on_done);
+        });
+
+    for (auto& producer: producers)
+        producer.join();
+
+    const auto done = completed.get_future();
+    BOOST_REQUIRE(done.wait_for(std::chrono::seconds(10)) ==
+        std::future_status::ready);
+
+    client.stop();
+    BOOST_REQUIRE_EQUAL(failed.load(), 0u);
+    BOOST_REQUIRE_EQUAL(server.requests(), threads * requests);
+}
+
+BOOST_AUTO_TEST_CASE(client__stop__pending_request__service_stopped)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(500);
+    BOOST_REQUIRE(client.start());
+
+    code result;
+    const auto on_done = [&result](const code& ec, size_t)
+    {
+        result = ec;
+    };
+
+    client.blockchain_fetch_last_height(on_done);
+    client.stop();
+
+    BOOST_REQUIRE_EQUAL(result, error::service_stopped);
+}
+
+BOOST_AUTO_TEST_CASE(client__connect__pool__requests_balanced)
+{
+    obelisk_server first;
+    obelisk_server second;
+    BOOST_REQUIRE(first.start());
+    BOOST_REQUIRE(second.start());
+
+    static const uint32_t retries = 0;
+    const std::vector<config::endpoint> servers
+    {
+        first.endpoint(), second.endpoint()
+    };
+
+    obelisk_client client(retries);
+    BOOST_REQUIRE(client.connect(servers));
+    BOOST_REQUIRE_EQUAL(client.connections(), 2u);
+
+    size_t calls = 0;
+    const auto on_done = [&calls](const code& ec, size_t height)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(height, test_height);
+        ++calls;
+    };
+
+    for (auto request = 0; request < 10; ++request)
+        client.blockchain_fetch_last_height(on_done);
+
+    // Requests are unanswered until wait(), so they alternate connections.
+    BOOST_REQUIRE_EQUAL(client.outstanding(0), 5u);
+    BOOST_REQUIRE_EQUAL(client.outstanding(1), 5u);
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(calls, 10u);
+    BOOST_REQUIRE_EQUAL(client.outstanding(0), 0u);
+    BOOST_REQUIRE_EQUAL(client.outstanding(1), 0u);
+    BOOST_REQUIRE_EQUAL(first.requests(), 5u);
+    BOOST_REQUIRE_EQUAL(second.requests(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(client__connect__pool_busy_connection__least_outstanding)
+{
+    obelisk_server first;
+    obelisk_server second;
+    BOOST_REQUIRE(first.start());
+    BOOST_REQUIRE(second.start());
+    first.set_latency(300);
+
+    static const uint32_t retries = 0;
+    const std::vector<config::endpoint> servers
+    {
+        first.endpoint(), second.endpoint()
+    };
+
+    obelisk_client client(retries);
+    BOOST_REQUIRE(client.connect(servers));
+    BOOST_REQUIRE(client.start());
+
+    std::atomic<size_t> calls(0);
+    std::promise<void> completed;
+    const auto on_done = [&](const code&, size_t)
+    {
+        if (++calls == 3)
+            completed.set_value();
+    };
+
+    // The second request is answered while the first remains outstanding,
+    // so the third is sent on the second connection, though next in turn
+    // is the first.
+    client.blockchain_fetch_last_height(on_done);
+    client.blockchain_fetch_last_height(on_done);
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    client.blockchain_fetch_last_height(on_done);
+
+    const auto done = completed.get_future();
+    BOOST_REQUIRE(done.wait_for(std::chrono::seconds(10)) ==
+        std::future_status::ready);
+
+    client.stop();
+    BOOST_REQUIRE_EQUAL(first.requests(), 1u);
+    BOOST_REQUIRE_EQUAL(second.requests(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_window__burst__held_then_released)
+{
+    MOCK_TEST_SETUP;
+
+    std::vector<bool> signals;
+    client.set_window(2, [&signals](bool backlogged)
+    {
+        signals.push_back(backlogged);
+    });
+
+    size_t calls = 0;
+    const auto on_done = [&calls](const code& ec, size_t height)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(height, test_height);
+        ++calls;
+    };
+
+    for (auto request = 0; request < 10; ++request)
+        client.blockchain_fetch_last_height(on_done);
+
+    // Only the window is sent, the remainder is held until wait().
+    BOOST_REQUIRE_EQUAL(client.outstanding(0), 2u);
+    BOOST_REQUIRE(client.backlogged());
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(calls, 10u);
+    BOOST_REQUIRE(!client.backlogged());
+    BOOST_REQUIRE_EQUAL(server.requests(), 10u);
+    BOOST_REQUIRE_EQUAL(signals.size(), 2u);
+    BOOST_REQUIRE(signals.front());
+    BOOST_REQUIRE(!signals.back());
+}
+
+BOOST_AUTO_TEST_CASE(client__set_window__held_request_timeout__not_sent)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(200);
+    client.set_window(1);
+
+    code sent_result;
+    const auto on_sent = [&sent_result](const code& ec, size_t)
+    {
+        sent_result = ec;
+    };
+
+    code held_result;
+    const auto on_held = [&held_result](const code& ec, size_t)
+    {
+        held_result = ec;
+    };
+
+    client.blockchain_fetch_last_height(on_sent);
+    client.blockchain_fetch_last_height(on_held, 20);
+    client.wait(10000);
+
+    BOOST_REQUIRE_EQUAL(sent_result, error::success);
+    BOOST_REQUIRE_EQUAL(held_result, error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(server.requests(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_adaptive__burst__limited_then_released)
+{
+    MOCK_TEST_SETUP;
+    client.set_adaptive(true);
+    const auto initial = client.limit(0);
+
+    size_t calls = 0;
+    const auto on_done = [&calls](const code& ec, size_t)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        ++calls;
+    };
+
+    for (size_t request = 0; request < 3 * initial; ++request)
+        client.blockchain_fetch_last_height(on_done);
+
+    // The connection is sent no more than its limit until wait().
+    BOOST_REQUIRE_EQUAL(client.outstanding(0), initial);
+    BOOST_REQUIRE(client.backlogged());
+
+    client.wait();
+    BOOST_REQUIRE_EQUAL(calls, 3 * initial);
+    BOOST_REQUIRE(!client.backlogged());
+    BOOST_REQUIRE_EQUAL(server.requests(), 3 * initial);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_adaptive__request_timeout__limit_backs_off)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(200);
+    client.set_adaptive(true);
+    const auto initial = client.limit(0);
+
+    code result;
+    const auto on_done = [&result](const code& ec, size_t)
+    {
+        result = ec;
+    };
+
+    client.blockchain_fetch_last_height(on_done, 20);
+    client.wait(10000);
+
+    BOOST_REQUIRE_EQUAL(result, error::channel_timeout);
+    BOOST_REQUIRE_LT(client.limit(0), initial);
+    BOOST_REQUIRE_EQUAL(client.outstanding(0), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_transaction__mock__expected_outputs)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(3);
+
+    size_t outputs = 0;
+    const auto on_done = [&outputs](const code& ec,
+        const chain::transaction& tx)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        outputs = tx.outputs().size();
+    };
+
+    client.blockchain_fetch_transaction(on_done, hash_literal(test_tx_hash));
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(outputs, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_transaction__identical_in_flight__coalesced)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(3);
+
+    size_t outputs = 0;
+    const auto on_done = [&outputs](const code& ec,
+        const chain::transaction& tx)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        outputs += tx.outputs().size();
+    };
+
+    client.blockchain_fetch_transaction(on_done, hash_literal(test_tx_hash));
+    client.blockchain_fetch_transaction(on_done, hash_literal(test_tx_hash));
+    client.blockchain_fetch_transaction(on_done, hash_literal(test_tx_hash));
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(outputs, 9u);
+    BOOST_REQUIRE_EQUAL(server.requests(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block__block_and_view_in_flight__not_coalesced)
+{
+    MOCK_TEST_SETUP;
+
+    size_t answered = 0;
+    const auto on_block = [&answered](const code& ec, const chain::block&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        ++answered;
+    };
+
+    const auto on_view = [&answered](const code& ec, const block_view&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        ++answered;
+    };
+
+    client.blockchain_fetch_block(on_block, test_height);
+    client.blockchain_fetch_block_view(on_view, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(answered, 2u);
+    BOOST_REQUIRE_EQUAL(server.requests(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block__coalesced_latency_exceeds_wait__all_channel_timeout)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(500);
+
+    std::vector<code> results;
+    const auto on_done = [&results](const code& ec, const chain::block&)
+    {
+        results.push_back(ec);
+    };
+
+    client.blockchain_fetch_block(on_done, test_height);
+    client.blockchain_fetch_block(on_done, test_height);
+    client.wait(50);
+
+    BOOST_REQUIRE_EQUAL(results.size(), 2u);
+    BOOST_REQUIRE_EQUAL(results[0], error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(results[1], error::channel_timeout);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block__coalesced_follower_timeout__follower_fails_alone)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(200);
+
+    std::vector<code> results;
+    const auto on_done = [&results](const code& ec, const chain::block&)
+    {
+        results.push_back(ec);
+    };
+
+    client.blockchain_fetch_block(on_done, test_height);
+    client.blockchain_fetch_block(on_done, test_height, 20);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(server.requests(), 1u);
+    BOOST_REQUIRE_EQUAL(results.size(), 2u);
+    BOOST_REQUIRE_EQUAL(results[0], error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(results[1], error::success);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block__outlives_in_flight_deadline__not_coalesced)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(200);
+
+    std::vector<code> results;
+    const auto on_done = [&results](const code& ec, const chain::block&)
+    {
+        results.push_back(ec);
+    };
+
+    client.blockchain_fetch_block(on_done, test_height, 20);
+    client.blockchain_fetch_block(on_done, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(server.requests(), 2u);
+    BOOST_REQUIRE_EQUAL(results.size(), 2u);
+    BOOST_REQUIRE_EQUAL(results[0], error::channel_timeout);
+    BOOST_REQUIRE_EQUAL(results[1], error::success);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block__mock__expected_transactions)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(10);
+
+    size_t transactions = 0;
+    const auto on_done = [&transactions](const code& ec,
+        const chain::block& block)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        transactions = block.transactions().size();
+    };
+
+    client.blockchain_fetch_block(on_done, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(transactions, 10u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block_view__mock__expected_transactions)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(10);
+
+    size_t transactions = 0;
+    bool last_valid = false;
+    const auto on_done = [&](const code& ec, const block_view& view)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        transactions = view.size();
+        last_valid = view.transaction(view.size() - 1u).is_valid();
+    };
+
+    client.blockchain_fetch_block_view(on_done, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(transactions, 10u);
+    BOOST_REQUIRE(last_valid);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block_view__truncated_response__bad_stream)
+{
+    // The response is shorter than its code.
+    obelisk_server server;
+    server.script("blockchain.fetch_block", [](const data_chunk&)
+    {
+        return data_chunk{ 0x00 };
+    });
+
+    BOOST_REQUIRE(server.start());
+    obelisk_client client(0);
+    BOOST_REQUIRE(client.connect(server.endpoint()));
+
+    code result;
+    const auto on_done = [&result](const code& ec, const block_view&)
+    {
+        result = ec;
+    };
+
+    client.blockchain_fetch_block_view(on_done, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(result, error::bad_stream);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_cache__fetch_block_by_hash_twice__second_cached)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(10);
+    client.set_cache(1024 * 1024);
+
+    size_t transactions = 0;
+    const auto on_done = [&transactions](const code& ec,
+        const chain::block& block)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        transactions += block.transactions().size();
+    };
+
+    client.blockchain_fetch_block(on_done, hash_literal(test_block_hash));
+    client.wait();
+
+    // The second is answered by wait(), not within the fetcher.
+    client.blockchain_fetch_block(on_done, hash_literal(test_block_hash));
+    BOOST_REQUIRE_EQUAL(transactions, 10u);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(transactions, 20u);
+    BOOST_REQUIRE_EQUAL(server.requests(), 1u);
+    BOOST_REQUIRE_EQUAL(client.cache()->hits(), 1u);
+    BOOST_REQUIRE_EQUAL(client.cache()->misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_cache__fetch_header_by_height__cached_only_if_buried)
+{
+    MOCK_TEST_SETUP;
+    client.set_cache(1024 * 1024, 6);
+
+    size_t answered = 0;
+    const auto on_done = [&answered](const code& ec, const chain::header&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        ++answered;
+    };
+
+    // The top height is seen in the last height response.
+    client.blockchain_fetch_last_height([](const code&, size_t) {});
+    client.wait();
+
+    // Twice within the depth and twice below it.
+    for (size_t fetch = 0; fetch < 2; ++fetch)
+    {
+        client.blockchain_fetch_block_header(on_done, test_height - 5);
+        client.blockchain_fetch_block_header(on_done, test_height - 6);
+        client.wait();
+    }
+
+    BOOST_REQUIRE_EQUAL(answered, 4u);
+    BOOST_REQUIRE_EQUAL(server.requests(), 4u);
+    BOOST_REQUIRE_EQUAL(client.cache()->hits(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_blocks__window__height_order)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(3);
+
+    std::vector<size_t> heights;
+    const auto on_block = [&heights](const code& ec, size_t height,
+        const chain::block& block)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE_EQUAL(block.transactions().size(), 3u);
+        heights.push_back(height);
+    };
+
+    client.blockchain_fetch_blocks(on_block, 10, 25, 4);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(heights.size(), 16u);
+    for (size_t index = 0; index < heights.size(); ++index)
+        BOOST_REQUIRE_EQUAL(heights[index], 10u + index);
+}
+
+BOOST_AUTO_TEST_CASE(client__set_cache__fetch_blocks_cached_range__height_order_unsent)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(3);
+    client.set_cache(1024 * 1024);
+
+    std::vector<size_t> heights;
+    const auto on_block = [&heights](const code& ec, size_t height,
+        const chain::block&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        heights.push_back(height);
+    };
+
+    client.blockchain_fetch_last_height([](const code&, size_t) {});
+    client.wait();
+    client.blockchain_fetch_blocks(on_block, 10, 25, 4);
+    client.wait();
+
+    const auto requests = server.requests();
+    heights.clear();
+
+    // Cached blocks are answered by wait(), each fetching the next.
+    client.blockchain_fetch_blocks(on_block, 10, 25, 4);
+    BOOST_REQUIRE(heights.empty());
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(server.requests(), requests);
+    BOOST_REQUIRE_EQUAL(heights.size(), 16u);
+    for (size_t index = 0; index < heights.size(); ++index)
+        BOOST_REQUIRE_EQUAL(heights[index], 10u + index);
+}
+
+BOOST_AUTO_TEST_CASE(client__start__fetch_blocks__height_order)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(3);
+    BOOST_REQUIRE(client.start());
+
+    // The first window is requested here while the reactor answers it.
+    std::vector<size_t> heights;
+    std::promise<void> completed;
+    const auto on_block = [&](const code& ec, size_t height,
+        const chain::block&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        heights.push_back(height);
+        if (height == 50u)
+            completed.set_value();
+    };
+
+    client.blockchain_fetch_blocks(on_block, 10, 50, 8);
+
+    const auto done = completed.get_future();
+    BOOST_REQUIRE(done.wait_for(std::chrono::seconds(10)) ==
+        std::future_status::ready);
+
+    client.stop();
+    BOOST_REQUIRE_EQUAL(heights.size(), 41u);
+    for (size_t index = 0; index < heights.size(); ++index)
+        BOOST_REQUIRE_EQUAL(heights[index], 10u + index);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_blocks__inverted_range__operation_failed)
+{
+    MOCK_TEST_SETUP;
+
+    size_t calls = 0;
+    const auto on_block = [&calls](const code& ec, size_t height,
+        const chain::block&)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::operation_failed);
+        BOOST_REQUIRE_EQUAL(height, 25u);
+        ++calls;
+    };
+
+    client.blockchain_fetch_blocks(on_block, 25, 10);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(calls, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__track_blocks__catch_up__delivered_by_monitor)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(2);
+
+    // No feed is published, the blocks are those fetched to catch up.
+    size_t delivered = 0;
+    const auto on_block = [&delivered](const chain::block& block)
+    {
+        BOOST_REQUIRE_EQUAL(block.transactions().size(), 2u);
+        ++delivered;
+    };
+
+    BOOST_REQUIRE(client.subscribe_block(server.endpoint(), on_block));
+    BOOST_REQUIRE(client.track_blocks(10, 13));
+    client.wait();
+    BOOST_REQUIRE_EQUAL(delivered, 0u);
+
+    client.monitor(0);
+    BOOST_REQUIRE_EQUAL(delivered, 3u);
+    BOOST_REQUIRE_EQUAL(client.block_height(), 13u);
+}
+
+BOOST_AUTO_TEST_CASE(client__track_blocks__no_block_subscription__sequenced)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(2);
+
+    BOOST_REQUIRE(client.track_blocks(10, 13));
+    client.wait();
+
+    BOOST_REQUIRE_NO_THROW(client.monitor(0));
+    BOOST_REQUIRE_EQUAL(client.block_height(), 13u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_block_transaction_hashes__mock__expected)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(7);
+
+    size_t hashes = 0;
+    const auto on_done = [&hashes](const code& ec, const hash_list& list)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        hashes = list.size();
+    };
+
+    client.blockchain_fetch_block_transaction_hashes(on_done, test_height);
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(hashes, 7u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_history4__mock__spends_correlated)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(4);
+
+    history::list received;
+    const auto on_done = [&received](const code& ec,
+        const history::list& rows)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received = rows;
+    };
+
+    client.blockchain_fetch_history4(on_done, hash_literal(test_key));
+    client.wait();
+
+    BOOST_REQUIRE_EQUAL(received.size(), 2u);
+    BOOST_REQUIRE(!received[0].spend.is_null());
+    BOOST_REQUIRE(!received[1].spend.is_null());
+    BOOST_REQUIRE_EQUAL(received[0].spend_height, 1u);
+    BOOST_REQUIRE_EQUAL(received[1].spend_height, 3u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_history4_columns__mock__spends_correlated)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(5);
+
+    history_columns received;
+    const auto on_done = [&received](const code& ec,
+        const history_columns& columns)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        received = columns;
+    };
+
+    client.blockchain_fetch_history4_columns(on_done, hash_literal(test_key));
+    client.wait();
+
+    // Rows 0 and 2 are spent by rows 1 and 3, row 4 is unspent.
+    BOOST_REQUIRE_EQUAL(received.size(), 3u);
+    BOOST_REQUIRE_EQUAL(received.spend_heights[0], 1u);
+    BOOST_REQUIRE_EQUAL(received.spend_heights[1], 3u);
+    BOOST_REQUIRE_EQUAL(received.unspent(), 1u);
+    BOOST_REQUIRE_EQUAL(received.balance(), 1004u);
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_history4_chunks__mock__chunks_correlated)
+{
+    MOCK_TEST_SETUP;
+    server.set_response_size(10);
+
+    std::vector<history::list> chunks;
+    auto completed = false;
+    const auto on_chunk = [&](const code& ec, const history::list& rows,
+        bool complete)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::success);
+        BOOST_REQUIRE(!completed);
+        chunks.push_back(rows);
+        completed = complete;
+    };
+
+    client.blockchain_fetch_history4_chunks(on_chunk, hash_literal(test_key),
+        2);
+    client.wait();
+
+    // Five correlated rows in chunks of two, the last flagged complete.
+    BOOST_REQUIRE(completed);
+    BOOST_REQUIRE_EQUAL(chunks.size(), 3u);
+    BOOST_REQUIRE_EQUAL(chunks[0].size(), 2u);
+    BOOST_REQUIRE_EQUAL(chunks[1].size(), 2u);
+    BOOST_REQUIRE_EQUAL(chunks[2].size(), 1u);
+    BOOST_REQUIRE_EQUAL(chunks[0][1].spend_height, 3u);
+    BOOST_REQUIRE_EQUAL(chunks[2][0].spend_height, 9u);
+
+    for (const auto& chunk: chunks)
+        for (const auto& row: chunk)
+            BOOST_REQUIRE(!row.spend.is_null());
+}
+
+BOOST_AUTO_TEST_CASE(client__fetch_history4_chunks__mock_latency_exceeds_wait__single_failed_chunk)
+{
+    MOCK_TEST_SETUP;
+    server.set_latency(500);
+
+    size_t calls = 0;
+    const auto on_chunk = [&calls](const code& ec, const history::list& rows,
+        bool complete)
+    {
+        BOOST_REQUIRE_EQUAL(ec, error::channel_timeout);
+        BOOST_REQUIRE(rows.empty());
+        BOOST_REQUIRE(complete);
+        ++calls;
+    };
+
+    client.blockchain_fetch_history4_chunks(on_chunk, hash_literal(test_key),
+        2);
+    client.wait(50);
+
+    BOOST_REQUIRE_EQUAL(calls, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(client__subscribe_key__mock__notified_then_timeout)
+{
+    MOCK_TEST_SETUP;
+
+    std::vector<code> codes;
+    std::vector<size_t> heights;
+    const auto on_update = [&codes, &heights](const code& ec, uint16_t,
+        size_t height, const hash_digest&)
+    {
+        codes.push_back(ec);
+        heights.push_back(height);
+    };
+
+    client.subscribe_key(on_update, hash_literal(test_key));
+    client.monitor(200);
+
+    // Subscribed, subscription response, notification, timeout.
+    BOOST_REQUIRE_EQUAL(codes.size(), 4u);
+    BOOST_REQUIRE_EQUAL(codes[0], error::success);
+    BOOST_REQUIRE_EQUAL(codes[1], error::success);
+    BOOST_REQUIRE_EQUAL(codes[2], error::success);
+    BOOST_REQUIRE_EQUAL(heights[2], test_height);
+    BOOST_REQUIRE_EQUAL(codes[3], error::channel_timeout);
+}
+
+BOOST_AUTO_TEST_CASE(client__subscribe_key__mock_direct_send__notified_then_timeout)
+{
+    MOCK_DIRECT_TEST_SETUP;
+
+    std::vector<code> codes;
+    std::vector<size_t> heights;
+    const auto on_update = [&codes, &heights](const code& ec, uint16_t,
+        size_t height, const hash_digest&)
+    {
+        codes.push_back(ec);
+        heights.push_back(height);
+    };
+
+    client.subscribe_key(on_update, hash_literal(test_key));
+    client.monitor(200);
+
+    // Subscribed, subscription response, notification, timeout.
+    BOOST_REQUIRE_EQUAL(codes.size(), 4u);
+    BOOST_REQUIRE_EQUAL(codes[0], error::success);
+    BOOST_REQUIRE_EQUAL(codes[1], error::success);
+    BOOST_REQUIRE_EQUAL(codes[2], error::success);
+    BOOST_REQUIRE_EQUAL(heights[2], test_height);
+    BOOST_REQUIRE_EQUAL(codes[3], error::channel_timeout);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE(network)
 
 BOOST_AUTO_TEST_CASE(client__fetch_history4__test)
@@ -0,0 +1,239 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+
+typedef request_table<std::string> string_table;
+
+BOOST_AUTO_TEST_SUITE(request_table_tests)
+
+BOOST_AUTO_TEST_CASE(request_table__construct__capacity__rounded_to_power_of_two)
+{
+    const string_table table(5);
+    BOOST_REQUIRE_EQUAL(table.capacity(), 8u);
+    BOOST_REQUIRE(table.empty());
+}
+
+BOOST_AUTO_TEST_CASE(request_table__insert__duplicate__false)
+{
+    string_table table;
+    BOOST_REQUIRE(table.insert(1, "a"));
+    BOOST_REQUIRE(!table.insert(1, "b"));
+    BOOST_REQUIRE_EQUAL(*table.find(1), "a");
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(request_table__find__missing__null)
+{
+    string_table table;
+    BOOST_REQUIRE(table.insert(1, "a"));
+    BOOST_REQUIRE(table.find(2) == nullptr);
+    BOOST_REQUIRE(table.find(1 + string_table::default_capacity) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(request_table__take__present__moved_and_removed)
+{
+    string_table table;
+    BOOST_REQUIRE(table.insert(42, "a"));
+
+    std::string value;
+    BOOST_REQUIRE(table.take(42, value));
+    BOOST_REQUIRE_EQUAL(value, "a");
+    BOOST_REQUIRE(table.empty());
+    BOOST_REQUIRE(!table.take(42, value));
+}
+
+BOOST_AUTO_TEST_CASE(request_table__insert__window_exceeds_capacity__grows)
+{
+    string_table table(4);
+
+    for (uint32_t id = 1; id <= 100; ++id)
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+
+    BOOST_REQUIRE_EQUAL(table.size(), 100u);
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+
+    for (uint32_t id = 1; id <= 100; ++id)
+        BOOST_REQUIRE_EQUAL(*table.find(id), std::to_string(id));
+}
+
+BOOST_AUTO_TEST_CASE(request_table__insert__sliding_window__no_growth)
+{
+    string_table table(4);
+
+    // At most four requests in flight at any time.
+    for (uint32_t id = 1; id <= 1000; ++id)
+    {
+        BOOST_REQUIRE(table.insert(id, "x"));
+        if (id > 3)
+            BOOST_REQUIRE(table.erase(id - 3));
+    }
+
+    BOOST_REQUIRE_EQUAL(table.size(), 3u);
+    BOOST_REQUIRE_EQUAL(table.capacity(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(request_table__erase__sparse_after_burst__shrinks_to_constructed)
+{
+    string_table table(4);
+
+    for (uint32_t id = 1; id <= 100; ++id)
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+
+    // The burst is answered, then requests are answered one at a time.
+    for (uint32_t id = 1; id < 100; ++id)
+        BOOST_REQUIRE(table.erase(id));
+
+    for (uint32_t id = 101; id <= 2000; ++id)
+    {
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+        BOOST_REQUIRE(table.erase(id - 1));
+    }
+
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+    BOOST_REQUIRE_EQUAL(table.capacity(), 4u);
+    BOOST_REQUIRE_EQUAL(*table.find(2000), "2000");
+}
+
+BOOST_AUTO_TEST_CASE(request_table__erase__sparse_with_colliding_ids__retained)
+{
+    string_table table(4);
+
+    for (uint32_t id = 1; id <= 100; ++id)
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+
+    // Ids 1 and 65 share a slot in a ring of 64.
+    for (uint32_t id = 2; id <= 100; ++id)
+        if (id != 65u)
+            BOOST_REQUIRE(table.erase(id));
+
+    for (auto count = 0; count < 1000; ++count)
+    {
+        BOOST_REQUIRE(table.insert(101, "x"));
+        BOOST_REQUIRE(table.erase(101));
+    }
+
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+    BOOST_REQUIRE_EQUAL(*table.find(1), "1");
+    BOOST_REQUIRE_EQUAL(*table.find(65), "65");
+}
+
+BOOST_AUTO_TEST_CASE(request_table__erase__survivor_with_churn__does_not_alternate)
+{
+    string_table table(4);
+    BOOST_REQUIRE(table.insert(0, "0"));
+
+    // Id 4 collides with the survivor in a ring of four, id 1 does not.
+    size_t resizes = 0;
+    auto capacity = table.capacity();
+    const auto churn = [&](uint32_t id)
+    {
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+        BOOST_REQUIRE(table.erase(id));
+        resizes += table.capacity() != capacity ? 1u : 0u;
+        capacity = table.capacity();
+    };
+
+    for (auto cycle = 0; cycle < 10; ++cycle)
+    {
+        churn(4);
+        for (auto count = 0; count < 100; ++count)
+            churn(1);
+    }
+
+    // Doubled, halved, then doubled again and retained.
+    BOOST_REQUIRE_EQUAL(resizes, 3u);
+    BOOST_REQUIRE_EQUAL(table.capacity(), 8u);
+    BOOST_REQUIRE_EQUAL(*table.find(0), "0");
+}
+
+BOOST_AUTO_TEST_CASE(request_table__drain__after_sparse_removals__counter_reset)
+{
+    string_table table(4);
+    for (uint32_t id = 1; id <= 100; ++id)
+        BOOST_REQUIRE(table.insert(id, std::to_string(id)));
+
+    // One removal short of halving the ring.
+    for (uint32_t id = 1; id < 100; ++id)
+        BOOST_REQUIRE(table.erase(id));
+
+    for (auto count = 0; count < 96; ++count)
+    {
+        BOOST_REQUIRE(table.insert(200, "200"));
+        BOOST_REQUIRE(table.erase(200));
+    }
+
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+    table.drain([](uint32_t, std::string&) {});
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+
+    // Removals made before the drain do not count towards halving.
+    BOOST_REQUIRE(table.insert(101, "101"));
+    BOOST_REQUIRE(table.insert(102, "102"));
+    BOOST_REQUIRE(table.erase(101));
+    BOOST_REQUIRE_EQUAL(table.capacity(), 128u);
+}
+
+BOOST_AUTO_TEST_CASE(request_table__insert__maximum_capacity__overflow_retained)
+{
+    string_table table(string_table::maximum_capacity);
+    const uint32_t old_id = 7;
+    const uint32_t new_id = old_id + string_table::maximum_capacity;
+
+    BOOST_REQUIRE(table.insert(old_id, "old"));
+    BOOST_REQUIRE(table.insert(new_id, "new"));
+    BOOST_REQUIRE_EQUAL(table.capacity(), string_table::maximum_capacity);
+    BOOST_REQUIRE_EQUAL(table.size(), 2u);
+    BOOST_REQUIRE_EQUAL(*table.find(old_id), "old");
+    BOOST_REQUIRE_EQUAL(*table.find(new_id), "new");
+
+    std::string value;
+    BOOST_REQUIRE(table.take(old_id, value));
+    BOOST_REQUIRE_EQUAL(value, "old");
+    BOOST_REQUIRE_EQUAL(table.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(request_table__drain__visitor_inserts__retained_not_visited)
+{
+    string_table table;
+    BOOST_REQUIRE(table.insert(1, "a"));
+    BOOST_REQUIRE(table.insert(2, "b"));
+
+    size_t visited = 0;
+    table.drain([&](uint32_t id, std::string&)
+    {
+        ++visited;
+        table.insert(id + 10, "c");
+    });
+
+    BOOST_REQUIRE_EQUAL(visited, 2u);
+    BOOST_REQUIRE_EQUAL(table.size(), 2u);
+    BOOST_REQUIRE(table.find(1) == nullptr);
+    BOOST_REQUIRE(table.find(11) != nullptr);
+    BOOST_REQUIRE(table.find(12) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
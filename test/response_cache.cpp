@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace bc::system;
+
+// Keys and responses are identified by a single byte.
+static data_chunk key_of(uint8_t id)
+{
+    return { id };
+}
+
+static data_chunk response_of(uint8_t id, size_t size=16)
+{
+    return data_chunk(size, id);
+}
+
+BOOST_AUTO_TEST_SUITE(response_cache_tests)
+
+BOOST_AUTO_TEST_CASE(response_cache__find__empty__miss)
+{
+    response_cache cache(4096);
+    BOOST_REQUIRE(!cache.find(key_of(1)));
+    BOOST_REQUIRE_EQUAL(cache.hits(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.misses(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__find__stored__hit)
+{
+    response_cache cache(4096);
+    cache.store(key_of(1), response_of(1));
+
+    const auto cached = cache.find(key_of(1));
+    BOOST_REQUIRE(cached);
+    BOOST_REQUIRE(*cached == response_of(1));
+    BOOST_REQUIRE_EQUAL(cache.hits(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.misses(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__store__existing__replaced)
+{
+    response_cache cache(4096);
+    cache.store(key_of(1), response_of(1));
+    const auto bytes = cache.bytes();
+    cache.store(key_of(1), response_of(2));
+
+    BOOST_REQUIRE(*cache.find(key_of(1)) == response_of(2));
+    BOOST_REQUIRE_EQUAL(cache.size(), 1u);
+    BOOST_REQUIRE_EQUAL(cache.bytes(), bytes);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__construct__small_budget__one_shard)
+{
+    const response_cache cache(4096, 4);
+    BOOST_REQUIRE_EQUAL(cache.shards(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__construct__large_budget__minimum_shares)
+{
+    const response_cache small(3u * response_cache::minimum_share);
+    BOOST_REQUIRE_EQUAL(small.shards(), 3u);
+
+    const response_cache large(64u * response_cache::minimum_share);
+    BOOST_REQUIRE_EQUAL(large.shards(), response_cache::default_shards);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__store__large_block_within_budget__cached)
+{
+    response_cache cache(16u * 1024u * 1024u);
+    cache.store(key_of(1), response_of(1, 4u * 1024u * 1024u));
+
+    BOOST_REQUIRE(cache.find(key_of(1)));
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__store__exceeds_share__not_cached)
+{
+    response_cache cache(4096, 4);
+    cache.store(key_of(1), response_of(1, 8192));
+
+    BOOST_REQUIRE(!cache.find(key_of(1)));
+    BOOST_REQUIRE_EQUAL(cache.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__store__over_budget__least_recent_evicted)
+{
+    // A single shard fits two of the entries.
+    response_cache cache(800, 1);
+    cache.store(key_of(1), response_of(1, 200));
+    cache.store(key_of(2), response_of(2, 200));
+
+    // Use the first, so that the second is the least recently used.
+    BOOST_REQUIRE(cache.find(key_of(1)));
+    cache.store(key_of(3), response_of(3, 200));
+
+    BOOST_REQUIRE(cache.find(key_of(1)));
+    BOOST_REQUIRE(!cache.find(key_of(2)));
+    BOOST_REQUIRE(cache.find(key_of(3)));
+    BOOST_REQUIRE_EQUAL(cache.size(), 2u);
+    BOOST_REQUIRE(cache.bytes() <= 800u);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__find__evicted_response__retained_by_holder)
+{
+    response_cache cache(800, 1);
+    cache.store(key_of(1), response_of(1, 200));
+    const auto held = cache.find(key_of(1));
+    cache.clear();
+
+    BOOST_REQUIRE(!cache.find(key_of(1)));
+    BOOST_REQUIRE(*held == response_of(1, 200));
+}
+
+BOOST_AUTO_TEST_CASE(response_cache__clear__stored__empty_counters_retained)
+{
+    response_cache cache(4096);
+    cache.store(key_of(1), response_of(1));
+    cache.store(key_of(2), response_of(2));
+    cache.find(key_of(1));
+    cache.clear();
+
+    BOOST_REQUIRE_EQUAL(cache.size(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.bytes(), 0u);
+    BOOST_REQUIRE_EQUAL(cache.hits(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
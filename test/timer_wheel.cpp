@@ -0,0 +1,181 @@
+/**
+ * Copyright (c) 2011-2023 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdint>
+#include <boost/test/test_tools.hpp>
+#include <boost/test/unit_test_suite.hpp>
+#include <bitcoin/client.hpp>
+
+using namespace bc::client;
+using namespace std::chrono;
+
+static const timer_wheel::clock::time_point start{};
+
+static timer_wheel::clock::time_point at(uint64_t tick)
+{
+    return start + milliseconds(tick);
+}
+
+BOOST_AUTO_TEST_SUITE(timer_wheel_tests)
+
+BOOST_AUTO_TEST_CASE(timer_wheel__construct__empty)
+{
+    const timer_wheel wheel(start);
+    BOOST_REQUIRE(wheel.empty());
+    BOOST_REQUIRE(wheel.next_expiry() == timer_wheel::clock::time_point::max());
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__before_deadline__none_expired)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(10));
+
+    timer_wheel::timers expired;
+    wheel.advance(at(9), expired);
+    BOOST_REQUIRE(expired.empty());
+    BOOST_REQUIRE_EQUAL(wheel.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__at_deadline__expired)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::blockchain_fetch_block, at(10));
+
+    timer_wheel::timers expired;
+    wheel.advance(at(10), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+    BOOST_REQUIRE_EQUAL(expired.front().id, 1u);
+    BOOST_REQUIRE(expired.front().type == command::blockchain_fetch_block);
+    BOOST_REQUIRE(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__past_deadline__expired_once)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(5));
+
+    timer_wheel::timers expired;
+    wheel.advance(at(100), expired);
+    wheel.advance(at(200), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__mixed_levels__expire_individually)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(5));
+    wheel.schedule(2, command::server_version, at(64));
+    wheel.schedule(3, command::server_version, at(2000));
+    wheel.schedule(4, command::server_version, at(300000));
+
+    timer_wheel::timers expired;
+    wheel.advance(at(63), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+    BOOST_REQUIRE_EQUAL(expired.back().id, 1u);
+
+    wheel.advance(at(64), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 2u);
+    BOOST_REQUIRE_EQUAL(expired.back().id, 2u);
+
+    wheel.advance(at(1999), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 2u);
+
+    wheel.advance(at(2000), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 3u);
+    BOOST_REQUIRE_EQUAL(expired.back().id, 3u);
+
+    wheel.advance(at(299999), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 3u);
+
+    wheel.advance(at(300000), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 4u);
+    BOOST_REQUIRE_EQUAL(expired.back().id, 4u);
+    BOOST_REQUIRE(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__beyond_top_level__expired)
+{
+    static const uint64_t distant = (uint64_t(1) << 24) + 7;
+
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(distant));
+
+    timer_wheel::timers expired;
+    wheel.advance(at(distant - 1), expired);
+    BOOST_REQUIRE(expired.empty());
+
+    wheel.advance(at(distant), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__advance__after_idle_day__expire_individually)
+{
+    static const uint64_t day = 24 * 60 * 60 * 1000;
+
+    timer_wheel wheel(start);
+    timer_wheel::timers expired;
+    wheel.schedule(1, command::server_version, at(5));
+    wheel.advance(at(5), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+
+    // Scheduled before the idle wheel is advanced.
+    wheel.schedule(2, command::server_version, at(day + 5));
+    wheel.schedule(3, command::server_version, at(day + 70000));
+
+    expired.clear();
+    wheel.advance(at(day + 4), expired);
+    BOOST_REQUIRE(expired.empty());
+
+    wheel.advance(at(day + 5), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+    BOOST_REQUIRE_EQUAL(expired.front().id, 2u);
+
+    wheel.advance(at(day + 69999), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 1u);
+
+    wheel.advance(at(day + 70000), expired);
+    BOOST_REQUIRE_EQUAL(expired.size(), 2u);
+    BOOST_REQUIRE_EQUAL(expired.back().id, 3u);
+    BOOST_REQUIRE(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__next_expiry__not_after_deadline)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(5000));
+    BOOST_REQUIRE(wheel.next_expiry() <= at(5000));
+
+    wheel.schedule(2, command::server_version, at(3));
+    BOOST_REQUIRE(wheel.next_expiry() == at(3));
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__clear__scheduled__empty)
+{
+    timer_wheel wheel(start);
+    wheel.schedule(1, command::server_version, at(5));
+    wheel.schedule(2, command::server_version, at(5000));
+    wheel.clear();
+    BOOST_REQUIRE(wheel.empty());
+
+    timer_wheel::timers expired;
+    wheel.advance(at(10000), expired);
+    BOOST_REQUIRE(expired.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()